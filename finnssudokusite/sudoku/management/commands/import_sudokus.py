@@ -71,7 +71,7 @@ class Command(BaseCommand):
     def get_solution(self, solver_path, json_path):
         try:
             result = subprocess.run(
-                [solver_path, "solve", json_path, "2", "1000000"],
+                [solver_path, "unique", "--json", json_path, "--node_limit", "1000000"],
                 stdout=subprocess.PIPE,
                 stderr=subprocess.PIPE,
                 text=True,
@@ -83,11 +83,9 @@ class Command(BaseCommand):
         if result.returncode != 0:
             return None
 
+        # the solver only prints a solution if it is the only one
         output = result.stdout
-        if (
-                "interrupted_by_node_limit=true" in output
-                or "interrupted_by_solution_limit=true" in output
-        ):
+        if "[INFO]uniqueness=unique" not in output.splitlines():
             return None
 
         solutions = [
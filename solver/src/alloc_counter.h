@@ -0,0 +1,32 @@
+/**
+ * @file alloc_counter.h
+ * @brief Optional count of heap allocations, used to keep the solve loop allocation free.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * When the project is built with SUDOKU_COUNT_ALLOCATIONS defined (CMake option of the same
+ * name), the global operator new is replaced by a counting version and every solve reports the
+ * number of allocations it made in its SolverStats. Otherwise the counter always reads zero and
+ * costs nothing.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace sudoku::alloc_counter {
+
+#ifdef SUDOKU_COUNT_ALLOCATIONS
+constexpr bool enabled = true;
+
+/// Heap allocations made by all threads since the program started
+uint64_t count();
+#else
+constexpr bool enabled = false;
+
+inline uint64_t count() { return 0; }
+#endif
+
+} // namespace sudoku::alloc_counter
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -8,6 +9,7 @@
 #include <sstream>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
 
 class ArgParser {
 public:
@@ -128,19 +130,19 @@ private:
     std::string active_command;
 
     template<typename T>
-    T convert(const std::string& s) const;
-
-    template<>
-    int convert<int>(const std::string& s) const { return std::stoi(s); }
-
-    template<>
-    bool convert<bool>(const std::string& s) const {
-        return s == "1" || s == "true" || s == "yes";
+    T convert(const std::string& s) const {
+        if constexpr (std::is_same_v<T, int>) {
+            return std::stoi(s);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return std::stoull(s);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return s == "1" || s == "true" || s == "yes";
+        } else {
+            static_assert(std::is_same_v<T, std::string>, "Unsupported argument type");
+            return s;
+        }
     }
 
-    template<>
-    std::string convert<std::string>(const std::string& s) const { return s; }
-
 public:
     const std::string& command_name() const {
         return active_command;
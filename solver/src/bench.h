@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -28,8 +29,13 @@ void print_header(const std::string &title) {
  * @param max_solutions How many solutions to find per puzzle
  * @param max_nodes Max decision nodes to explore per puzzle
  * @param solve_complete If true, does a complete solve
+ * @param heuristic Branching heuristic used by the solver
+ * @param restart_unit Nodes of the shortest run between search restarts (0 = no restarts)
+ * @param seed Seed of every puzzle's board, so repeated benchmarks explore the same nodes
  */
-void bench(const std::string &directory_path, int max_solutions, int max_nodes, bool solve_complete) {
+void bench(const std::string &directory_path, int max_solutions, int max_nodes, bool solve_complete,
+           BranchHeuristic heuristic = BranchHeuristic::Impact, int restart_unit = 0,
+           uint64_t seed = DEFAULT_SEED) {
     print_header("BENCHMARK STARTING");
 
     std::vector<std::string> json_files;
@@ -79,7 +85,11 @@ void bench(const std::string &directory_path, int max_solutions, int max_nodes,
     int total_puzzles = 0;
     int total_solutions = 0;
     int total_guesses = 0;
+    uint64_t total_handler_calls = 0;
     uint64_t total_nodes = 0;
+    uint64_t total_allocations = 0;
+    int total_restarts = 0;
+    std::vector<int> puzzle_nodes; // nodes of every puzzle, for the tail of the distribution
     int successful_solutions = 0;
     float total_time_ms = 0;
 
@@ -105,6 +115,9 @@ void bench(const std::string &directory_path, int max_solutions, int max_nodes,
 
             Board board{9};
             board.from_json(root);
+            board.set_heuristic(heuristic);
+            board.set_restart_unit(restart_unit);
+            board.set_seed(seed);
 
             SolverStats stats;
             auto sol = solve_complete ? board.solve_complete(&stats, max_nodes)
@@ -116,7 +129,11 @@ void bench(const std::string &directory_path, int max_solutions, int max_nodes,
             total_solutions += stats.solutions_found;
             total_nodes += stats.nodes_explored;
             total_guesses += stats.guesses_made;
+            total_handler_calls += stats.handler_calls;
             total_time_ms += stats.time_taken_ms;
+            total_allocations += stats.allocations;
+            total_restarts += stats.restarts;
+            puzzle_nodes.push_back(stats.nodes_explored);
 
             if (!sol.empty())
                 successful_solutions++;
@@ -145,10 +162,32 @@ void bench(const std::string &directory_path, int max_solutions, int max_nodes,
     std::cout << "| " << std::setw(26) << std::left << "Total nodes:";
     std::cout << std::setw(12) << std::right << total_nodes << " |\n";
 
+    // 99th percentile of the nodes per puzzle (nearest rank)
+    if (!puzzle_nodes.empty()) {
+        std::sort(puzzle_nodes.begin(), puzzle_nodes.end());
+        const std::size_t rank = (puzzle_nodes.size() * 99 + 99) / 100;
+        std::cout << "| " << std::setw(26) << std::left << "P99 nodes:";
+        std::cout << std::setw(12) << std::right << puzzle_nodes[rank - 1] << " |\n";
+    }
+
+    // Total restarts row
+    std::cout << "| " << std::setw(26) << std::left << "Total restarts:";
+    std::cout << std::setw(12) << std::right << total_restarts << " |\n";
+
     // Total guesses row
     std::cout << "| " << std::setw(26) << std::left << "Total guesses:";
     std::cout << std::setw(12) << std::right << total_guesses << " |\n";
 
+    // Total handler calls row
+    std::cout << "| " << std::setw(26) << std::left << "Total handler calls:";
+    std::cout << std::setw(12) << std::right << total_handler_calls << " |\n";
+
+    // Total allocations row (only counted in builds with SUDOKU_COUNT_ALLOCATIONS)
+    if (alloc_counter::enabled) {
+        std::cout << "| " << std::setw(26) << std::left << "Total allocations:";
+        std::cout << std::setw(12) << std::right << total_allocations << " |\n";
+    }
+
     // Total time row
     std::cout << "| " << std::setw(26) << std::left << "Total time (ms):";
     std::stringstream time_ss;
@@ -5,82 +5,135 @@
 namespace sudoku {
 
 Board::Board(int size) :
-    board_size_(size), block_size_(static_cast<int>(std::sqrt(size))), grid_(size), impact_map_(size) {
-    // Initialize all cells with their position and board size
+    geometry_(geometry_for(size)), board_size_(size), block_size_(geometry_.block_size), cell_count_(size * size),
+    impact_map_(size), failure_map_(size) {
+    candidates_.fill(NumberSet::full(size));
+
+    // Initialize all cells with their position and their slots in the state arrays
+    cells_.reserve(cell_count_);
     for (Row r = 0; r < size; ++r) {
-        grid_[r].reserve(size);
         for (Col c = 0; c < size; ++c) {
-            grid_[r].emplace_back(CellIdx{r, c}, size);
+            const int idx = r * size + c;
+            cells_.emplace_back(CellIdx{r, c}, values_[idx], candidates_[idx], size);
+            cells_.back().board_ = this;
         }
     }
 
     initialize_accessors();
 
-    if (block_size_ * block_size_ == size) {
-        initialize_blocks();
-    }
+    if (DigitBoard::supports(size))
+        digit_board_ = std::make_unique<DigitBoard>(geometry_);
 
-    snapshot_pool_.resize(size * size);
-    for (auto &snap: snapshot_pool_)
-        snap.resize(board_size_ * board_size_);
+    trail_.reserve(4 * size * size * size, size * size);
+    changed_cells_.reserve(cell_count_);
+    watchers_.resize(cell_count_);
+    subscribers_.resize(cell_count_);
+    neighbours_.resize(cell_count_);
+    index_cells();
 }
 
 void Board::initialize_accessors() {
-    rows_.resize(board_size_);
-    cols_.resize(board_size_);
-
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            rows_[r].push_back(&grid_[r][c]);
-            cols_[c].push_back(&grid_[r][c]);
+    auto accessors = [this](int first, int count) {
+        std::vector<std::vector<Cell *>> res(count);
+        for (int u = 0; u < count; ++u) {
+            const auto *unit = geometry_.unit(first + u);
+            for (int i = 0; i < board_size_; ++i)
+                res[u].push_back(&cells_[unit[i]]);
         }
-    }
+        return res;
+    };
+
+    rows_ = accessors(0, board_size_);
+    cols_ = accessors(board_size_, board_size_);
+    if (geometry_.has_blocks)
+        blocks_ = accessors(2 * board_size_, board_size_);
 }
 
-void Board::initialize_blocks() {
-    blocks_.resize(board_size_);
+void Board::index_cells() {
+    candidate_buckets_.assign(board_size_ + 1, CellMask{});
+    cell_bucket_.assign(cell_count_, -1);
+    unsolved_cells_ = 0;
 
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            int block_row = r / block_size_;
-            int block_col = c / block_size_;
-            int block_index = block_row * block_size_ + block_col;
-            blocks_[block_index].push_back(&grid_[r][c]);
-        }
-    }
+    for (const Cell &cell: cells_)
+        index_cell(cell);
 }
 
-Cell &Board::get_cell(const CellIdx &idx) { return grid_.at(idx.r).at(idx.c); }
-
 std::vector<Cell *> &Board::get_row(Row r) { return rows_.at(r); }
 
 std::vector<Cell *> &Board::get_col(Col c) { return cols_.at(c); }
 
 std::vector<Cell *> &Board::get_block(Row r, Col c) {
-    assert(block_size_ * block_size_ == board_size_);
-    int block_row = r / block_size_;
-    int block_col = c / block_size_;
-    int block_index = block_row * block_size_ + block_col;
-    return blocks_.at(block_index);
+    assert(geometry_.has_blocks);
+    return blocks_.at(geometry_.units_of(flat_index({r, c}))[2] - 2 * board_size_);
+}
+
+void Board::watch_handler(int handler) {
+    if (!handlers_[handler])
+        return;
+    for (const CellIdx &pos: handlers_[handler]->watched_cells())
+        watchers_[pos.r * board_size_ + pos.c].push_back(handler);
+    for (const CellIdx &pos: handlers_[handler]->subscribed_cells())
+        subscribers_[pos.r * board_size_ + pos.c].push_back(handler);
+}
+
+void Board::index_handlers() {
+    for (auto &watchers: watchers_)
+        watchers.clear();
+    for (auto &subscribers: subscribers_)
+        subscribers.clear();
+
+    const int count = static_cast<int>(handlers_.size());
+    wake_queue_.assign(count, 0);
+    queued_.assign(count, 0);
+    handler_check_stamp_.assign(count, 0);
+    checked_handlers_.reserve(count);
+
+    rules_.clear();
+    for (const auto &handler: handlers_)
+        rules_.push_back(make_rule_ref(handler.get()));
+    wake_head_ = 0;
+    wake_size_ = 0;
+
+    for (int i = 0; i < count; ++i) {
+        watch_handler(i);
+        wake(i);
+    }
+
+    neighbours_.assign(cell_count_, CellMask{});
+    for (const auto &handler: handlers_) {
+        if (!handler)
+            continue;
+        for (const auto &group: handler->constraint_groups()) {
+            CellMask cells;
+            for (const CellIdx &pos: group)
+                cells.set(pos.r * board_size_ + pos.c);
+            for (int idx: cells)
+                neighbours_[idx] |= cells;
+        }
+    }
+    for (int idx = 0; idx < cell_count_; ++idx)
+        neighbours_[idx].reset(idx);
 }
 
 void Board::add_handler(std::shared_ptr<RuleHandler> handler) {
     handlers_.push_back(std::move(handler));
+    index_handlers();
     this->process_rule_candidates();
 }
 
 void Board::init_randomly() {
     for (const auto &handler: handlers_)
         handler->init_randomly();
+
+    // the watched cells depend on the rule configuration
+    index_handlers();
 }
 
 void Board::clear() {
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            grid_[r][c].clear();
-        }
-    }
+    for (Cell &cell: cells_)
+        cell.clear();
     impact_map_.reset();
+    reset_failure_map();
 }
 
 } // namespace sudoku
@@ -6,7 +6,7 @@
  * It defines the core board structure and state management logic, including:
  * - Cell access by row, column, and block
  * - Rule handler registration and execution
- * - History stack for backtracking
+ * - Undo trail for backtracking
  * - An internal impact map to support heuristic-based solving
  *
  * @date 2025-05-16
@@ -15,24 +15,71 @@
 
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <stack>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "../cell.h"
+#include "../cell_mask.h"
 #include "../impact_map.h"
+#include "../rng.h"
 #include "../number_set.h"
 #include "../rules/_rule_handler.h"
+#include "../rules/rule_ref.h"
 #include "../solution.h"
 #include "../solver_stats.h"
+#include "digit_board.h"
+#include "geometry.h"
+#include "trail.h"
 
 
 namespace sudoku {
 
+/**
+ * @brief Strategy used by Board::get_next_cell() to pick the cell to branch on.
+ */
+enum class BranchHeuristic {
+    Impact, ///< Fewest candidates, ties broken by the static impact map
+    Weighted, ///< Smallest candidate count per failure weight (dom/wdeg), learned during the search
+};
+
+/**
+ * @brief Parses a heuristic name ("impact" or "wdeg").
+ * @throws std::runtime_error for unknown names
+ */
+BranchHeuristic parse_branch_heuristic(const std::string &name);
+
+/**
+ * @brief Answer of Board::check_unique().
+ */
+enum class Uniqueness {
+    None, ///< The puzzle has no solution
+    Unique, ///< The puzzle has exactly one solution
+    Multiple, ///< The puzzle has at least two solutions
+    Unknown, ///< The node budget ran out before the answer was known
+};
+
+/**
+ * @brief Returns the name of an answer ("none", "unique", "multiple" or "unknown").
+ */
+const char *uniqueness_name(Uniqueness uniqueness);
+
+/**
+ * @struct UniquenessResult
+ * @brief Result of Board::check_unique().
+ */
+struct UniquenessResult {
+    Uniqueness status = Uniqueness::Unknown; ///< Number of solutions
+    std::optional<Solution> solution; ///< The solution, only set if it is unique
+};
+
 /**
  * @class Board
  * @brief Represents the current state of a Sudoku puzzle and its solving logic.
@@ -48,6 +95,10 @@ public:
      */
     explicit Board(int size);
 
+    /// Cells and rule handlers keep pointers to their board, so a board can neither be copied nor moved.
+    Board(const Board &) = delete;
+    Board &operator=(const Board &) = delete;
+
     /**
      * loads from json
      * @param json
@@ -55,15 +106,63 @@ public:
     void from_json(JSON &json);
 
     /**
-     * @brief Serialize the board to JSON.
+     * @brief Serialize the board (fixed cells and rules) to JSON.
      * @return JSON representation of the board.
      */
+    JSON to_json() const;
+
+    /**
+     * @brief Serialize the board to a JSON file.
+     * @param file_path Path of the file to write
+     */
     void to_json(const std::string file_path) const;
 
     /**
-     * @brief Access a specific cell by index.
+     * @brief Access a specific cell by index. The index is only checked in debug builds.
+     */
+    Cell &get_cell(const CellIdx &idx) { return cells_[flat_index(idx)]; }
+    const Cell &get_cell(const CellIdx &idx) const { return cells_[flat_index(idx)]; }
+
+    /**
+     * @brief Flat index of a cell (r * size + c), as used by all per-cell tables of the board.
+     */
+    int flat_index(const CellIdx &idx) const {
+        assert(idx.r >= 0 && idx.r < board_size_ && idx.c >= 0 && idx.c < board_size_);
+        return idx.r * board_size_ + idx.c;
+    }
+
+    /**
+     * @brief Access a cell by its flat index (see flat_index()).
+     */
+    Cell &get_cell(int idx) {
+        assert(idx >= 0 && idx < cell_count_);
+        return cells_[idx];
+    }
+    const Cell &get_cell(int idx) const {
+        assert(idx >= 0 && idx < cell_count_);
+        return cells_[idx];
+    }
+
+    /**
+     * @brief Unit and peer tables of this board size.
+     */
+    const GeometryView &geometry() const { return geometry_; }
+
+    /**
+     * @brief Per-digit bitboards of the candidates, or nullptr if the board is too large for them.
+     */
+    const DigitBoard *digit_board() const { return digit_board_.get(); }
+
+    /**
+     * @brief Candidate masks of all cells by flat index. The array always holds
+     * MAX_SIZE * MAX_SIZE entries, so vector loads may read past the last cell.
+     */
+    const NumberSet *candidate_data() const { return candidates_.data(); }
+
+    /**
+     * @brief Values of all cells by flat index (EMPTY for unsolved cells).
      */
-    Cell &get_cell(const CellIdx &idx);
+    const Number *value_data() const { return values_.data(); }
 
     /**
      * @brief Access an entire row by index.
@@ -95,25 +194,50 @@ public:
     /**
      * @brief Returns false if any contradiction is detected (e.g., empty cell with no candidates).
      * Or any rule handler dislikes the board.
+     *
+     * This scans the whole board; placements made by set_cell() are checked incrementally instead.
      */
     bool valid() const;
 
     /**
-     * @brief Push the current board state onto the history stack.
+     * @brief Called by rule handlers when propagation runs into a violated constraint.
+     *
+     * Propagation stops as soon as possible and the current placement is rejected.
+     */
+    void report_contradiction() { contradiction_ = true; }
+
+    /**
+     * @brief Open a checkpoint on the undo trail.
+     *
+     * Cells modified afterwards record their previous state once, so undoing only touches
+     * the cells that actually changed.
      */
     void push_history();
 
     /**
-     * @brief Pop the previous state from the history stack and restore it.
-     * @return True if successful, false if stack was empty.
+     * @brief Undo all modifications since the last checkpoint and close it.
+     * @return True if successful, false if no checkpoint was open.
      */
     bool pop_history();
 
+    /**
+     * @brief Number of currently open checkpoints.
+     */
+    int history_depth() const { return trail_.depth(); }
+
+    /**
+     * @brief Undo checkpoints until only `depth` of them remain open.
+     * @param depth Target depth as returned by history_depth()
+     */
+    void restore_history(int depth);
+
     /**
      * @brief Set a number at a given cell.
      *
      * If `force` is false (default), the move is only applied if it's valid
-     * and the board remains consistent. If `force` is true, the value is applied
+     * and the board remains consistent. Consistency is checked while propagating (a cell
+     * losing all candidates or a handler reporting a contradiction) and afterwards only for
+     * the constraints touching the modified cells. If `force` is true, the value is applied
      * directly with no checks or history tracking.
      *
      * @param idx Cell index
@@ -129,12 +253,16 @@ public:
     bool is_solved() const;
 
     /**
-     * @brief Process candidate updates by invoking `candidates_changed()` on all rules until no change occurs.
+     * @brief Propagate candidate updates until no rule handler is waiting anymore.
+     *
+     * A handler is woken whenever one of its watched cells changes (see RuleHandler::watched_cells())
+     * and `candidates_changed()` is only invoked on woken handlers, in the order they were woken.
      */
     void process_rule_candidates();
 
     /**
-     * @brief Notify all rule handlers that a number has changed at a specific cell.
+     * @brief Notify the rule handlers subscribed to a cell (see RuleHandler::subscribed_cells()) that its
+     * number has changed.
      */
     void process_rule_number_changed(const CellIdx &idx);
 
@@ -145,6 +273,11 @@ public:
      */
     void update_impact_map();
 
+    /**
+     * @brief Total number of rule handler invocations (number_changed and candidates_changed) so far.
+     */
+    int handler_calls() const { return handler_calls_; }
+
     /**
      * @brief Initializes every rule handler randomly
      */
@@ -160,6 +293,16 @@ public:
      */
     const ImpactMap &impact_map() const;
 
+    /**
+     * @brief Read-only access to the failure weights learned by the weighted heuristic.
+     */
+    const ImpactMap &failure_map() const { return failure_map_; }
+
+    /**
+     * @brief Forget all failure weights learned so far.
+     */
+    void reset_failure_map();
+
     /**
      * @brief Get the board size (e.g. 9 for 9x9).
      */
@@ -192,43 +335,374 @@ public:
      */
     bool use_smart_hints() const { return use_smart_hints_; }
 
+    /**
+     * @brief Select the branching heuristic used by get_next_cell().
+     */
+    void set_heuristic(BranchHeuristic heuristic) { heuristic_ = heuristic; }
+
+    /**
+     * @brief Returns the branching heuristic used by get_next_cell().
+     */
+    BranchHeuristic heuristic() const { return heuristic_; }
+
+    /**
+     * @brief Enables restarts of the search until the first solution is found.
+     *
+     * The n-th run of the search is cut off after `unit * luby(n)` nodes and started again from
+     * the root, where the cell choice breaks ties differently. Failure weights learned by the
+     * weighted heuristic are kept across restarts. Since the budgets keep growing, a run
+     * eventually finishes, so no solution is lost. Once a solution has been found the search
+     * runs to the end without further restarts. solve_parallel() ignores the setting.
+     *
+     * @param unit Nodes of the shortest run, 0 disables restarts
+     */
+    void set_restart_unit(int unit) { restart_unit_ = unit; }
+
+    /**
+     * @brief Returns the node budget of the shortest run between restarts (0 = no restarts).
+     */
+    int restart_unit() const { return restart_unit_; }
+
+    /**
+     * @brief Reseeds the random generator of this board.
+     *
+     * All random decisions made through this board (tie-breaks of the cell choice, the probe order
+     * of solve_complete() and the random initialisation of the rules) draw from this generator, so
+     * the same seed reproduces the same search and the same node counts.
+     */
+    void set_seed(uint64_t seed) {
+        seed_ = seed;
+        rng_ = make_rng(seed);
+    }
+
+    /**
+     * @brief Returns the seed the random generator was last seeded with.
+     */
+    uint64_t seed() const { return seed_; }
+
+    /**
+     * @brief Random generator of this board.
+     *
+     * Drawing from it does not change the puzzle, so it is also available on const boards. A
+     * board and its generator must only be used by one thread at a time.
+     */
+    Rng &rng() const { return rng_; }
+
     std::vector<Solution> solve(int max_solutions = 1, int max_nodes = 1024, SolverStats *stats_out = nullptr);
-    CellIdx get_next_cell() const;
+
+    /**
+     * @brief Decides whether the puzzle has no, one or several solutions.
+     *
+     * Cheaper than solve(2, ...): only the first solution is copied, and the search then carries
+     * on behind it, so it only visits subtrees that disagree with the first solution in one of
+     * their decisions. It stops as soon as a second solution is found.
+     *
+     * @param max_nodes Node budget; the answer is Uniqueness::Unknown if it runs out first
+     * @param stats_out Optional statistics output
+     */
+    UniquenessResult check_unique(int max_nodes = 1024, SolverStats *stats_out = nullptr);
+
+    /**
+     * @brief Counts the solutions of the puzzle without storing them.
+     *
+     * Leaves of the search only increment a counter, so memory use does not depend on the number
+     * of solutions. Whenever the unsolved cells split into components that share no constraint
+     * group, the components are counted one after another and their counts multiplied, so
+     * independent regions cost the sum rather than the product of their search trees.
+     *
+     * @param limit The count stops (and saturates) at this many solutions
+     * @param max_nodes Node budget; the count is not exact if it runs out
+     * @param stats_out Optional statistics output
+     * @return Number of solutions, at most `limit`
+     */
+    uint64_t count_solutions(uint64_t limit, int max_nodes = 1024, SolverStats *stats_out = nullptr);
+
+    /**
+     * @brief Picks the cell to branch on.
+     * @param scope Only cells of this mask are considered (all cells if null)
+     */
+    CellIdx get_next_cell(const CellMask *scope = nullptr) const;
     std::vector<Number> get_random_candidates(const CellIdx &idx) const;
     Solution copy_solution() const;
-    Board clone_shallow() const;
+    std::unique_ptr<Board> clone_shallow() const;
+
+    /**
+     * @brief Create an independent, fully working copy of this board.
+     *
+     * Cell state, impact map, settings and the random generator state are copied and every rule
+     * handler is cloned and rebound to the new board. The copy starts with an empty history, i.e.
+     * the current state is its root.
+     */
+    std::unique_ptr<Board> clone() const;
+    /**
+     * @brief Multi-threaded variant of solve().
+     *
+     * The search tree is split into subtrees which are explored on per-thread copies of the board.
+     * Whenever a worker runs out of work, busy workers hand over the untried branches of their
+     * shallowest decision, which idle workers steal. The node budget and solution count are shared,
+     * and all workers stop as soon as `max_solutions` solutions have been found.
+     * Falls back to solve() for a single thread or when threads are unavailable.
+     *
+     * @param max_solutions Maximum number of solutions to collect
+     * @param max_nodes Node budget shared by all workers
+     * @param threads Number of worker threads (0 = hardware concurrency)
+     * @param stats_out Optional statistics output
+     */
+    std::vector<Solution> solve_parallel(int max_solutions = 1, int max_nodes = 1024, int threads = 0,
+                                         SolverStats *stats_out = nullptr);
     std::vector<Solution> solve_complete(SolverStats *stats_out = nullptr, int max_nodes = 1024,
                                          std::function<void(float)> onProgress = nullptr,
-                                         std::function<void(Solution &)> onSolution = nullptr);
+                                         std::function<void(Solution &)> onSolution = nullptr, int threads = 1);
 
 private:
+    friend class Cell;
+
+    GeometryView geometry_; ///< Compile-time unit and peer tables of this board size
     int board_size_; ///< Board size (typically 9)
     int block_size_; ///< Block dimension (e.g., 3 for 9x9)
+    int cell_count_; ///< Number of cells (board_size_ * board_size_)
+
+    static constexpr int MAX_CELLS = MAX_SIZE * MAX_SIZE;
 
-    std::vector<std::vector<Cell>> grid_; ///< 2D grid of cells
+    std::array<Number, MAX_CELLS> values_{}; ///< Value of every cell by flat index (0 = unsolved)
+    std::array<NumberSet, MAX_CELLS> candidates_{}; ///< Candidates of every cell by flat index
+    std::vector<Cell> cells_; ///< Cell handles viewing values_ and candidates_, by flat index
+    std::unique_ptr<DigitBoard> digit_board_; ///< Bitboard mirror of the candidates (boards up to 11x11)
     std::vector<std::vector<Cell *>> rows_; ///< Row accessors
     std::vector<std::vector<Cell *>> cols_; ///< Column accessors
     std::vector<std::vector<Cell *>> blocks_; ///< Block accessors
 
     std::vector<std::shared_ptr<RuleHandler>> handlers_; ///< All registered rule handlers
-
-    //   using Snapshot = std::vector<std::vector<std::pair<Number, NumberSet>>>;
-    //   std::stack<Snapshot> history_; ///< History stack for backtracking
-
-    std::vector<Snapshot> snapshot_pool_;
-    int history_top_ = -1;
-
+    std::vector<RuleRef> rules_; ///< handlers_ by their exact type, for calls without virtual dispatch
+
+    Trail trail_; ///< Undo trail for backtracking
+
+    std::vector<CellMask> candidate_buckets_; ///< Unsolved cells grouped by their candidate count
+    std::vector<int> cell_bucket_; ///< Current bucket of each cell (-1 if solved)
+    int unsolved_cells_ = 0; ///< Number of cells without a value
+    std::vector<CellMask> neighbours_; ///< Cells sharing a constraint group with each cell, by flat cell index
+
+    std::vector<std::vector<int>> watchers_; ///< Handlers watching each cell, by flat cell index
+    std::vector<std::vector<int>> subscribers_; ///< Handlers reacting to placements in each cell, by flat cell index
+    std::vector<int> wake_queue_; ///< Ring buffer of handlers waiting for candidates_changed()
+    std::vector<char> queued_; ///< Whether a handler is currently in the wake queue
+    int wake_head_ = 0; ///< Position of the next handler in the wake queue
+    int wake_size_ = 0; ///< Number of handlers in the wake queue
+    int handler_calls_ = 0; ///< Number of rule handler invocations
+
+    bool contradiction_ = false; ///< Set when a handler reported a contradiction during propagation
+    int failed_handler_ = -1; ///< Handler that caused the current contradiction (-1 if unknown)
+    std::vector<CellIdx> changed_cells_; ///< Cells modified by the current placement (consistent() buffer)
+    std::vector<int> checked_handlers_; ///< Handlers to check in consistent()
+    std::vector<uint32_t> handler_check_stamp_; ///< Last consistent() call that selected each handler
+    uint32_t check_stamp_ = 0; ///< Stamp of the current consistent() call
 
     ImpactMap impact_map_; ///< Per-cell heuristic values computed by rule handlers
+    ImpactMap failure_map_; ///< Per-cell failure weights of the weighted heuristic
+    int failures_ = 0; ///< Failed placements since the failure weights last decayed
+
+    static constexpr int FAILURE_WEIGHT = 16; ///< Weight added to a cell per failure (and its initial weight)
+    static constexpr int FAILURE_DECAY_INTERVAL = 256; ///< Failed placements between two decays
+    static constexpr float FAILURE_DECAY = 0.5f; ///< Factor applied to all failure weights on decay
 
     // smart hints enabled
     bool use_smart_hints_ = false;
 
+    BranchHeuristic heuristic_ = BranchHeuristic::Impact;
+    int restart_unit_ = 0; ///< Nodes of the shortest run between restarts (0 = no restarts)
+
+    uint64_t seed_ = DEFAULT_SEED; ///< Seed the generator was last seeded with
+    mutable Rng rng_ = make_rng(DEFAULT_SEED); ///< Source of all random decisions of this board
+
     void initialize_accessors();
-    void initialize_blocks();
+
+    /**
+     * @brief Moves a cell into the bucket matching its current state and mirrors it on the bitboards.
+     */
+    void index_cell(const Cell &cell) {
+        const int idx = cell.pos.r * board_size_ + cell.pos.c;
+        if (digit_board_)
+            digit_board_->update(idx, cell.value, cell.candidates);
+
+        const int bucket = cell.value == EMPTY ? cell.candidates.count() : -1;
+        int &current = cell_bucket_[idx];
+        if (bucket == current)
+            return;
+
+        if (current >= 0)
+            candidate_buckets_[current].reset(idx);
+        else
+            ++unsolved_cells_;
+
+        if (bucket >= 0)
+            candidate_buckets_[bucket].set(idx);
+        else
+            --unsolved_cells_;
+
+        current = bucket;
+    }
+
+    /**
+     * @brief Rebuilds the candidate buckets from scratch.
+     */
+    void index_cells();
+
+    /**
+     * @brief Called after a cell was modified: updates its bucket and wakes the handlers watching it.
+     *
+     * Restoring a cell from the trail only re-indexes it, since the restored state was already
+     * propagated when it was first reached.
+     */
+    void cell_changed(const Cell &cell) {
+        index_cell(cell);
+        for (int handler: watchers_[cell.pos.r * board_size_ + cell.pos.c])
+            wake(handler);
+    }
+
+    /**
+     * @brief Appends a handler to the wake queue unless it is already waiting.
+     */
+    void wake(int handler) {
+        if (queued_[handler])
+            return;
+        queued_[handler] = 1;
+
+        int tail = wake_head_ + wake_size_;
+        if (tail >= static_cast<int>(wake_queue_.size()))
+            tail -= static_cast<int>(wake_queue_.size());
+        wake_queue_[tail] = handler;
+        ++wake_size_;
+    }
+
+    /**
+     * @brief Returns true if propagation ran into a contradiction: an unsolved cell without
+     * candidates or a contradiction reported by a handler.
+     */
+    bool in_contradiction() const { return contradiction_ || candidate_buckets_[0].any(); }
+
+    /**
+     * @brief Checks the board after a placement.
+     *
+     * Only the handlers watching or subscribed to a cell modified since the last checkpoint are
+     * asked, and only about the constraints containing those cells.
+     */
+    bool consistent();
+
+    /**
+     * @brief Bumps the failure weight of the cells involved in the rejected placement.
+     *
+     * Must be called before the placement is undone. If the handler responsible for the
+     * contradiction is known, only the modified cells in its scope are bumped, otherwise all
+     * modified cells are. Weights decay every FAILURE_DECAY_INTERVAL failures.
+     */
+    void record_failure();
+
+    /**
+     * @brief Depth-first search below the current state, shared by solve(), check_unique() and
+     * solve_complete().
+     *
+     * Counts nodes, guesses and solutions into `stats` and calls `on_solution()` whenever every
+     * cell of the scope is solved; the search stops when it returns false or the node budget runs
+     * out. The board is restored to its starting state afterwards.
+     *
+     * @param scope Only these cells are branched on (all cells if null); cells outside the scope
+     *              must not share a constraint group with it
+     */
+    template<typename OnSolution>
+    void search(int max_nodes, SolverStats &stats, const CellMask *scope, OnSolution &&on_solution);
+
+    /**
+     * @brief Searches one solution of the cells in `scope` (all cells if null).
+     *
+     * The cells outside the scope are taken from `rest`, which must hold a solution of them.
+     */
+    std::optional<Solution> solve_scope(const CellMask *scope, const Solution &rest, int max_nodes,
+                                        SolverStats &stats);
+
+    /**
+     * @brief Splits the unsolved cells into independent components for the probes of solve_complete().
+     *
+     * Every component is solved once, so a probe only has to search the component of its cell.
+     * @param rest Receives the solved cells plus one solution of every component
+     * @param nodes_explored Incremented by the nodes spent
+     * @return The component of every unsolved cell by flat index; empty if the board does not
+     *         split or a component has no solution within the node budget
+     */
+    std::vector<CellMask> split_for_probes(Solution &rest, int max_nodes, int &nodes_explored);
+
+    /**
+     * @brief State shared by the recursive calls of count_scope().
+     */
+    struct CountState {
+        uint64_t limit; ///< Counts saturate at this value
+        int max_nodes; ///< Node budget
+        SolverStats &stats; ///< Nodes explored and interruptions
+    };
+
+    /**
+     * @brief Counts the completions of the unsolved cells in `scope`, splitting it into independent
+     * components first.
+     */
+    uint64_t count_scope(const CellMask &scope, CountState &state);
+
+    /**
+     * @brief Counts the completions of a connected set of unsolved cells by branching on one of them.
+     */
+    uint64_t count_component(const CellMask &component, CountState &state);
+
+    /**
+     * @brief Unsolved cells, by flat index.
+     */
+    CellMask unsolved_mask() const;
+
+    /**
+     * @brief Cells of `cells` reachable from `idx` through shared constraint groups.
+     */
+    CellMask component_of(int idx, const CellMask &cells) const;
+
+    /**
+     * @brief Splits `cells` into the components of the constraint graph.
+     */
+    std::vector<CellMask> components(CellMask cells) const;
+
+    /**
+     * @brief Picks the unsolved cell with the smallest candidate count per failure weight.
+     */
+    CellIdx get_next_cell_weighted(const CellMask *scope) const;
+
+    /**
+     * @brief Registers the watched and subscribed cells of the handler with the given index.
+     */
+    void watch_handler(int handler);
+
+    /**
+     * @brief Rebuilds the watcher and subscriber lists of all cells and wakes every handler.
+     */
+    void index_handlers();
+
+    /**
+     * @brief Thread-pool variant of solve_complete().
+     *
+     * The (cell, candidate) probes are distributed over worker threads, each with its own clone of
+     * the board. Coverage and proven eliminations are shared through atomic per-cell masks, so a
+     * solution found by one worker removes the pending probes of every candidate it covers.
+     * Callbacks are serialized.
+     */
+    std::vector<Solution> solve_complete_parallel(SolverStats *stats_out, int max_nodes,
+                                                  std::function<void(float)> onProgress,
+                                                  std::function<void(Solution &)> onSolution, int threads);
 };
 
 std::ostream &operator<<(std::ostream &os, Board &board);
 
+inline void Cell::assign(Number v, const NumberSet &next) {
+    if (board_)
+        board_->trail_.record(*this);
+    value = v;
+    candidates = next;
+    if (board_)
+        board_->cell_changed(*this);
+}
+
 
 } // namespace sudoku
@@ -1,7 +1,17 @@
 #include "board.h"
 
+#include <stdexcept>
+
 namespace sudoku {
 
+BranchHeuristic parse_branch_heuristic(const std::string &name) {
+    if (name == "impact")
+        return BranchHeuristic::Impact;
+    if (name == "wdeg")
+        return BranchHeuristic::Weighted;
+    throw std::runtime_error("Unknown heuristic: " + name);
+}
+
 /**
  * @brief Recomputes the full impact map by resetting and allowing each handler to increment affected cells.
  */
@@ -28,4 +38,12 @@ int Board::get_impact(const CellIdx &idx) const { return impact_map_.get(idx); }
  */
 const ImpactMap &Board::impact_map() const { return impact_map_; }
 
+/**
+ * @brief Clears the failure weights of the weighted heuristic and restarts the decay interval.
+ */
+void Board::reset_failure_map() {
+    failure_map_.reset();
+    failures_ = 0;
+}
+
 } // namespace sudoku
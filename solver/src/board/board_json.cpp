@@ -100,6 +100,10 @@ void Board::from_json(JSON &json) {
             Col c = static_cast<Col>(cell_json["c"].get<double>());
             Number val = static_cast<Number>(cell_json["value"].get<double>());
 
+            // cell access is unchecked in release builds
+            if (r < 0 || r >= board_size_ || c < 0 || c >= board_size_)
+                throw std::runtime_error("Fixed cell out of range");
+
             set_cell(CellIdx{r, c}, val, true);
         }
     }
@@ -108,14 +112,14 @@ void Board::from_json(JSON &json) {
     update_impact_map();
 }
 
-void Board::to_json(const std::string file_path) const {
+JSON Board::to_json() const {
     JSON json = JSON(JSON::object{});
 
     // create fixedCells array
     JSON::array fixed_cells;
     for (Row r = 0; r < board_size_; ++r) {
         for (Col c = 0; c < board_size_; ++c) {
-            const Cell &cell = grid_[r][c];
+            const Cell &cell = get_cell({r, c});
             if (cell.value != 0) {
                 JSON cell_json = JSON(JSON::object{});
                 cell_json["r"] = static_cast<double>(r);
@@ -139,6 +143,11 @@ void Board::to_json(const std::string file_path) const {
         }
     }
     json["rules"] = rules;
+    return json;
+}
+
+void Board::to_json(const std::string file_path) const {
+    JSON json = to_json();
 
     // write to file
     std::ofstream file_stream(file_path);
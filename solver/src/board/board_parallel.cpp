@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include "board.h"
+
+
+namespace sudoku {
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+
+namespace {
+
+/// Sequence of decisions leading from the root of the search to a subtree.
+using Path = std::vector<std::pair<CellIdx, Number>>;
+
+/// Per-worker task deque. The owner pops from the back, thieves steal from the front.
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Path> tasks;
+};
+
+/// Sum of the rule handler invocations made on the worker copies of a board.
+int fork_handler_calls(const std::vector<std::unique_ptr<Board>> &forks) {
+    int total = 0;
+    for (const auto &fork: forks)
+        total += fork->handler_calls();
+    return total;
+}
+
+} // namespace
+
+std::vector<Solution> Board::solve_parallel(int max_solutions, int max_nodes, int threads, SolverStats *stats_out) {
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads <= 1 || !valid())
+        return solve(max_solutions, max_nodes, stats_out);
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<Solution> solutions;
+    std::mutex solutions_mutex;
+
+    std::atomic<int> nodes_explored{0};
+    std::atomic<int> guesses_made{0};
+    std::atomic<int> pending{1}; // tasks queued or running
+    std::atomic<int> idle{0}; // workers waiting for work
+    std::atomic<bool> stop{false};
+    std::atomic<bool> interrupted_by_node_limit{false};
+    std::atomic<bool> interrupted_by_solution_limit{false};
+    std::exception_ptr error;
+
+    // every fork breaks ties from its own stream, derived from the seed of this board
+    std::vector<std::unique_ptr<Board>> forks;
+    for (int i = 1; i < threads; ++i) {
+        forks.push_back(clone());
+        forks.back()->set_seed(derive_seed(seed_, i));
+    }
+
+    // forks start counting from zero
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (int i = 0; i < threads; ++i)
+        queues.push_back(std::make_unique<WorkQueue>());
+    queues[0]->tasks.push_back({});
+
+    auto take_task = [&](int id, Path &task) {
+        {
+            WorkQueue &own = *queues[id];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (int k = 1; k < threads; ++k) {
+            WorkQueue &victim = *queues[(id + k) % threads];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto worker = [&](int id) {
+        Board &board = id == 0 ? *this : *forks[id - 1];
+        WorkQueue &own = *queues[id];
+        const int base_depth = board.history_depth();
+
+        struct Frame {
+            CellIdx pos;
+            NumberSet remaining;
+            Number current;
+            int mark;
+        };
+        std::vector<Frame> frames;
+        frames.reserve(board_size_ * board_size_ + 1);
+
+        Path task;
+
+        // Same node semantics as solve(), but with shared counters. Returns false if the search must stop.
+        auto enter = [&]() {
+            if (stop.load(std::memory_order_relaxed))
+                return false;
+
+            if (nodes_explored.fetch_add(1, std::memory_order_relaxed) >= max_nodes) {
+                interrupted_by_node_limit = true;
+                stop = true;
+                return false;
+            }
+
+            if (board.is_solved()) {
+                std::lock_guard<std::mutex> lock(solutions_mutex);
+                if (static_cast<int>(solutions.size()) < max_solutions)
+                    solutions.push_back(board.copy_solution());
+                if (static_cast<int>(solutions.size()) >= max_solutions) {
+                    interrupted_by_solution_limit = true;
+                    stop = true;
+                    return false;
+                }
+                return true;
+            }
+
+            const CellIdx pos = board.get_next_cell();
+            const Cell &cell = board.get_cell(pos);
+            if (cell.candidates.count() > 1)
+                guesses_made.fetch_add(1, std::memory_order_relaxed);
+
+            frames.push_back({pos, cell.candidates, 0, board.history_depth()});
+            return true;
+        };
+
+        // Hands the untried branches of the shallowest open decision over to idle workers.
+        auto donate = [&]() {
+            for (std::size_t k = 0; k < frames.size(); ++k) {
+                if (frames[k].remaining.count() == 0)
+                    continue;
+
+                Path prefix = task;
+                for (std::size_t j = 0; j < k; ++j)
+                    prefix.emplace_back(frames[j].pos, frames[j].current);
+
+                std::lock_guard<std::mutex> lock(own.mutex);
+                for (Number n: frames[k].remaining) {
+                    Path branch = prefix;
+                    branch.emplace_back(frames[k].pos, n);
+                    own.tasks.push_back(std::move(branch));
+                    pending.fetch_add(1);
+                }
+                frames[k].remaining.clear();
+                return;
+            }
+        };
+
+        auto run_task = [&]() {
+            board.restore_history(base_depth);
+            for (const auto &[pos, n]: task) {
+                if (!board.set_cell(pos, n))
+                    return;
+            }
+
+            frames.clear();
+            if (!enter())
+                return;
+
+            while (!frames.empty()) {
+                Frame &frame = frames.back();
+                board.restore_history(frame.mark);
+
+                if (frame.remaining.count() == 0) {
+                    frames.pop_back();
+                    continue;
+                }
+
+                const Number n = frame.remaining.lowest();
+                frame.remaining.remove(n);
+                frame.current = n;
+
+                if (board.set_cell(frame.pos, n)) {
+                    if (!enter())
+                        return;
+                    if (idle.load(std::memory_order_relaxed) > 0)
+                        donate();
+                }
+            }
+        };
+
+        try {
+            board.update_impact_map();
+            board.reset_failure_map();
+
+            bool waiting = false;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!take_task(id, task)) {
+                    if (pending.load() == 0)
+                        break;
+                    if (!waiting) {
+                        waiting = true;
+                        idle.fetch_add(1);
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (waiting) {
+                    waiting = false;
+                    idle.fetch_sub(1);
+                }
+
+                run_task();
+                pending.fetch_sub(1);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(solutions_mutex);
+            if (!error)
+                error = std::current_exception();
+            stop = true;
+        }
+
+        board.restore_history(base_depth);
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i)
+        pool.emplace_back(worker, i);
+    worker(0);
+    for (auto &thread: pool)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    const auto end_time = std::chrono::steady_clock::now();
+    float elapsed_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+
+    if (stats_out) {
+        *stats_out = SolverStats{.solutions_found = static_cast<int>(solutions.size()),
+                                 .nodes_explored = std::min(nodes_explored.load(), max_nodes + 1),
+                                 .guesses_made = guesses_made.load(),
+                                 .handler_calls = handler_calls_ - handler_calls + fork_handler_calls(forks),
+                                 .time_taken_ms = elapsed_ms,
+                                 .allocations = alloc_counter::count() - allocations,
+                                 .interrupted_by_node_limit = interrupted_by_node_limit,
+                                 .interrupted_by_solution_limit = interrupted_by_solution_limit};
+    }
+
+    return solutions;
+}
+
+std::vector<Solution> Board::solve_complete_parallel(SolverStats *stats_out, int max_nodes,
+                                                     std::function<void(float)> onProgress,
+                                                     std::function<void(Solution &)> onSolution, int threads) {
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads <= 1)
+        return solve_complete(stats_out, max_nodes, onProgress, onSolution, 1);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    update_impact_map();
+
+    std::vector<CellIdx> positions;
+    for (Row r = 0; r < board_size_; ++r)
+        for (Col c = 0; c < board_size_; ++c)
+            positions.push_back({r, c});
+
+    std::shuffle(positions.begin(), positions.end(), rng_);
+
+    // per cell: candidates not yet covered by any solution, and candidates proven impossible
+    const int cell_count = board_size_ * board_size_;
+    std::vector<std::atomic<NumberSet::bit_t>> uncovered(cell_count);
+    std::vector<std::atomic<NumberSet::bit_t>> eliminated(cell_count);
+
+    std::vector<std::pair<CellIdx, Number>> probes;
+    for (const CellIdx &idx: positions) {
+        const Cell &cell = get_cell(idx);
+        if (cell.is_solved())
+            continue;
+        uncovered[idx.r * board_size_ + idx.c] = cell.candidates.raw();
+        for (Number n: cell.candidates)
+            probes.emplace_back(idx, n);
+    }
+
+    std::vector<Solution> all_solutions;
+    std::unordered_set<Solution> unique_solutions;
+    std::mutex callback_mutex;
+
+    std::atomic<std::size_t> next_probe{0};
+    std::size_t finished_probes = 0;
+    std::atomic<int> nodes_explored{0};
+    std::exception_ptr error;
+
+    int split_nodes = 0;
+    Solution rest(board_size_);
+    const std::vector<CellMask> scopes = split_for_probes(rest, max_nodes, split_nodes);
+    nodes_explored += split_nodes;
+
+    // every fork breaks ties from its own stream, derived from the seed of this board
+    std::vector<std::unique_ptr<Board>> forks;
+    for (int i = 1; i < threads; ++i) {
+        forks.push_back(clone());
+        forks.back()->set_seed(derive_seed(seed_, i));
+    }
+
+    // forks start counting from zero
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
+
+    // Applies eliminations found by any worker to the root state of the given board.
+    auto sync_eliminations = [&](Board &board, std::vector<NumberSet::bit_t> &applied) {
+        for (int k = 0; k < cell_count; ++k) {
+            const NumberSet::bit_t fresh = eliminated[k].load(std::memory_order_relaxed) & ~applied[k];
+            if (!fresh)
+                continue;
+            applied[k] |= fresh;
+            board.get_cell({static_cast<Row>(k / board_size_), static_cast<Col>(k % board_size_)})
+                    .remove_candidates(NumberSet(board_size_, fresh));
+        }
+    };
+
+    auto worker = [&](int id) {
+        Board &board = id == 0 ? *this : *forks[id - 1];
+        std::vector<NumberSet::bit_t> applied(cell_count, 0);
+
+        try {
+            for (std::size_t i = next_probe++; i < probes.size(); i = next_probe++) {
+                const auto [idx, n] = probes[i];
+                const int k = idx.r * board_size_ + idx.c;
+                const NumberSet::bit_t bit = NumberSet::bit(n);
+
+                if (uncovered[k].load(std::memory_order_relaxed) & bit) {
+                    sync_eliminations(board, applied);
+
+                    if (!board.set_cell(idx, n)) {
+                        uncovered[k].fetch_and(~bit);
+                        eliminated[k].fetch_or(bit);
+                    } else {
+                        SolverStats local_stats;
+                        const CellMask *scope = scopes.empty() ? nullptr : &scopes[k];
+                        std::optional<Solution> found = board.solve_scope(scope, rest, max_nodes, local_stats);
+                        nodes_explored += local_stats.nodes_explored;
+
+                        if (found) {
+                            const Solution &sol = *found;
+                            for (Row r = 0; r < board_size_; ++r)
+                                for (Col c = 0; c < board_size_; ++c)
+                                    uncovered[r * board_size_ + c].fetch_and(~NumberSet::bit(sol.get(r, c)));
+
+                            std::lock_guard<std::mutex> lock(callback_mutex);
+                            if (unique_solutions.insert(sol).second) {
+                                all_solutions.push_back(sol);
+                                if (onSolution)
+                                    onSolution(all_solutions.back());
+                            }
+                        } else if (!local_stats.interrupted_by_node_limit) {
+                            uncovered[k].fetch_and(~bit);
+                            eliminated[k].fetch_or(bit);
+                        }
+
+                        board.pop_history();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                ++finished_probes;
+                if (onProgress)
+                    onProgress(static_cast<float>(finished_probes) / static_cast<float>(probes.size()));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(callback_mutex);
+            if (!error)
+                error = std::current_exception();
+            next_probe = probes.size();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i)
+        pool.emplace_back(worker, i);
+    worker(0);
+    for (auto &thread: pool)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    // keep every proven elimination on this board, like the serial version does
+    std::vector<NumberSet::bit_t> applied(cell_count, 0);
+    sync_eliminations(*this, applied);
+
+    const auto end_time = std::chrono::steady_clock::now();
+    float elapsed_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+
+    if (stats_out) {
+        stats_out->solutions_found = static_cast<int>(all_solutions.size());
+        stats_out->nodes_explored = nodes_explored;
+        stats_out->handler_calls = handler_calls_ - handler_calls + fork_handler_calls(forks);
+        stats_out->time_taken_ms = elapsed_ms;
+        stats_out->allocations = alloc_counter::count() - allocations;
+        stats_out->interrupted_by_node_limit = false;
+        stats_out->interrupted_by_solution_limit = false;
+    }
+
+    return all_solutions;
+}
+
+#else
+
+std::vector<Solution> Board::solve_parallel(int max_solutions, int max_nodes, int threads, SolverStats *stats_out) {
+    // no threads available in this build
+    return solve(max_solutions, max_nodes, stats_out);
+}
+
+std::vector<Solution> Board::solve_complete_parallel(SolverStats *stats_out, int max_nodes,
+                                                     std::function<void(float)> onProgress,
+                                                     std::function<void(Solution &)> onSolution, int threads) {
+    // no threads available in this build
+    return solve_complete(stats_out, max_nodes, onProgress, onSolution, 1);
+}
+
+#endif
+
+} // namespace sudoku
@@ -1,20 +1,58 @@
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+#include "../rules/include.h"
 #include "board.h"
 
 namespace sudoku {
 
+namespace {
+
+// The propagation calls below are bound to the exact rule type through a RuleRef; qualified calls
+// skip the vtable. Handlers of unknown types are called virtually.
+
+bool rule_number_changed(const RuleRef &rule, const CellIdx &pos) {
+    return std::visit([&pos](auto *handler) {
+        using T = std::remove_pointer_t<decltype(handler)>;
+        if constexpr (std::is_same_v<T, RuleHandler>)
+            return handler->number_changed(pos);
+        else
+            return handler->T::number_changed(pos);
+    }, rule);
+}
+
+bool rule_candidates_changed(const RuleRef &rule) {
+    return std::visit([](auto *handler) {
+        using T = std::remove_pointer_t<decltype(handler)>;
+        if constexpr (std::is_same_v<T, RuleHandler>)
+            return handler->candidates_changed();
+        else
+            return handler->T::candidates_changed();
+    }, rule);
+}
+
+bool rule_valid_changed(const RuleRef &rule, const std::vector<CellIdx> &cells) {
+    return std::visit([&cells](auto *handler) {
+        using T = std::remove_pointer_t<decltype(handler)>;
+        if constexpr (std::is_same_v<T, RuleHandler>)
+            return handler->valid_changed(cells);
+        else
+            return handler->T::valid_changed(cells);
+    }, rule);
+}
+
+} // namespace
+
 bool Board::is_valid_move(const CellIdx &idx, Number number) const {
-    const Cell &cell = grid_.at(idx.r).at(idx.c);
-    return cell.value == EMPTY && cell.candidates.test(number);
+    const int i = flat_index(idx);
+    return values_[i] == EMPTY && candidates_[i].test(number);
 }
 
 bool Board::valid() const {
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            const Cell &cell = grid_[r][c];
-            if (cell.value == EMPTY && cell.candidates.count() == 0)
-                return false;
-        }
-    }
+    for (int i = 0; i < cell_count_; ++i)
+        if (values_[i] == EMPTY && candidates_[i].count() == 0)
+            return false;
 
     for (const auto &handler: handlers_) {
         if (handler && !handler->valid())
@@ -24,46 +62,17 @@ bool Board::valid() const {
     return true;
 }
 
-bool Board::is_solved() const {
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            if (grid_[r][c].value == EMPTY)
-                return false;
-        }
-    }
-    return true;
-}
+bool Board::is_solved() const { return unsolved_cells_ == 0; }
 
-void Board::push_history() {
-    assert(history_top_ + 1 < static_cast<int>(snapshot_pool_.size()));
-    ++history_top_;
-    Snapshot &snap = snapshot_pool_[history_top_];
-
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            const Cell &cell = grid_[r][c];
-            int idx = r * board_size_ + c;
-            snap[idx].value = cell.value;
-            snap[idx].candidate_bits = cell.candidates.raw();
-        }
-    }
-}
+void Board::push_history() { trail_.push(); }
 
 bool Board::pop_history() {
-    if (history_top_ < 0)
-        return false;
-
-    const Snapshot &snap = snapshot_pool_[history_top_];
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            int idx = r * board_size_ + c;
-            grid_[r][c].value = snap[idx].value;
-            grid_[r][c].candidates = NumberSet(board_size_, snap[idx].candidate_bits);
-        }
-    }
+    return trail_.pop([this](const Cell &cell) { index_cell(cell); });
+}
 
-    --history_top_;
-    return true;
+void Board::restore_history(int depth) {
+    while (trail_.depth() > depth)
+        pop_history();
 }
 
 bool Board::set_cell(const CellIdx &idx, Number number, bool force) {
@@ -73,13 +82,18 @@ bool Board::set_cell(const CellIdx &idx, Number number, bool force) {
     if (!force)
         push_history();
 
+    contradiction_ = false;
+    failed_handler_ = -1;
+
     Cell &cell = get_cell(idx);
     cell.set_value(number);
 
     process_rule_number_changed(idx);
     process_rule_candidates();
 
-    if (!force && !valid()) {
+    if (!force && !consistent()) {
+        if (heuristic_ == BranchHeuristic::Weighted)
+            record_failure();
         pop_history();
         return false;
     }
@@ -87,23 +101,92 @@ bool Board::set_cell(const CellIdx &idx, Number number, bool force) {
     return true;
 }
 
+bool Board::consistent() {
+    if (in_contradiction())
+        return false;
 
-void Board::process_rule_number_changed(const CellIdx &idx) {
-    for (const auto &handler: handlers_) {
-        if (handler) {
-            handler->number_changed(idx);
+    changed_cells_.clear();
+    trail_.for_each_recorded([this](const Cell &cell) { changed_cells_.push_back(cell.pos); });
+
+    // select every handler touching a changed cell once
+    ++check_stamp_;
+    checked_handlers_.clear();
+    for (const CellIdx &pos: changed_cells_) {
+        const int idx = pos.r * board_size_ + pos.c;
+        for (const auto *list: {&watchers_[idx], &subscribers_[idx]}) {
+            for (int handler: *list) {
+                if (handler_check_stamp_[handler] == check_stamp_)
+                    continue;
+                handler_check_stamp_[handler] = check_stamp_;
+                checked_handlers_.push_back(handler);
+            }
+        }
+    }
+
+    for (int handler: checked_handlers_) {
+        if (!rule_valid_changed(rules_[handler], changed_cells_)) {
+            failed_handler_ = handler;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Board::record_failure() {
+    trail_.for_each_recorded([this](const Cell &cell) {
+        const int idx = cell.pos.r * board_size_ + cell.pos.c;
+        if (failed_handler_ >= 0) {
+            const auto &watchers = watchers_[idx];
+            const auto &subscribers = subscribers_[idx];
+            if (std::find(watchers.begin(), watchers.end(), failed_handler_) == watchers.end() &&
+                std::find(subscribers.begin(), subscribers.end(), failed_handler_) == subscribers.end())
+                return;
         }
+        failure_map_.increment(cell.pos, FAILURE_WEIGHT);
+    });
+
+    if (++failures_ >= FAILURE_DECAY_INTERVAL) {
+        failure_map_.scale(FAILURE_DECAY);
+        failures_ = 0;
+    }
+}
+
+void Board::process_rule_number_changed(const CellIdx &idx) {
+    for (int handler: subscribers_[idx.r * board_size_ + idx.c]) {
+        if (in_contradiction())
+            return;
+        ++handler_calls_;
+        rule_number_changed(rules_[handler], idx);
+        if (failed_handler_ < 0 && in_contradiction())
+            failed_handler_ = handler;
     }
 }
 
 void Board::process_rule_candidates() {
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (const auto &handler: handlers_) {
-            if (handler) {
-                changed |= handler->candidates_changed();
+    while (wake_size_ > 0) {
+        if (in_contradiction()) {
+            // the placement will be rejected, so the remaining handlers need not run
+            for (; wake_size_ > 0; --wake_size_) {
+                queued_[wake_queue_[wake_head_]] = 0;
+                if (++wake_head_ == static_cast<int>(wake_queue_.size()))
+                    wake_head_ = 0;
             }
+            return;
+        }
+
+        const int handler = wake_queue_[wake_head_];
+        if (++wake_head_ == static_cast<int>(wake_queue_.size()))
+            wake_head_ = 0;
+        --wake_size_;
+
+        // clear the flag first so changes made by the handler itself wake it again
+        queued_[handler] = 0;
+        if (handlers_[handler]) {
+            ++handler_calls_;
+            rule_candidates_changed(rules_[handler]);
+            if (failed_handler_ < 0 && in_contradiction())
+                failed_handler_ = handler;
         }
     }
 }
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <random>
 #include <unordered_set>
 #include "board.h"
@@ -7,12 +9,35 @@
 
 namespace sudoku {
 
+namespace {
+
+/**
+ * @brief The i-th term (from 1) of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+ */
+int luby(int i) {
+    int k = 1;
+    while ((1 << k) - 1 < i)
+        ++k;
+    while (i != (1 << k) - 1) {
+        i -= (1 << (k - 1)) - 1;
+        k = 1;
+        while ((1 << k) - 1 < i)
+            ++k;
+    }
+    return 1 << (k - 1);
+}
+
+} // namespace
+
 std::vector<Solution> Board::solve_complete(SolverStats *stats_out, int max_nodes,
                                             std::function<void(float)> onProgress,
-                                            std::function<void(Solution &)> onSolution) {
+                                            std::function<void(Solution &)> onSolution, int threads) {
+    if (threads != 1)
+        return solve_complete_parallel(stats_out, max_nodes, onProgress, onSolution, threads);
+
     std::vector<Solution> all_solutions;
     std::unordered_set<std::string> unique_solutions;
-    Board tracker = clone_shallow();
+    std::unique_ptr<Board> tracker = clone_shallow();
 
     update_impact_map();
 
@@ -21,38 +46,42 @@ std::vector<Solution> Board::solve_complete(SolverStats *stats_out, int max_node
         for (Col c = 0; c < board_size_; ++c)
             positions.push_back({r, c});
 
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(positions.begin(), positions.end(), g);
+    std::shuffle(positions.begin(), positions.end(), rng_);
 
     int nodes_explored = 0;
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
     const int total_positions = positions.size();
     int current_idx = 0;
 
     const auto start_time = std::chrono::steady_clock::now();
 
+    Solution rest(board_size_);
+    const std::vector<CellMask> scopes = split_for_probes(rest, max_nodes, nodes_explored);
+
     for (const CellIdx &idx: positions) {
         current_idx++;
         Cell &cell = this->get_cell(idx);
         if (cell.is_solved())
             continue;
 
-        Cell &tracker_cell = tracker.get_cell(idx);
+        Cell &tracker_cell = tracker->get_cell(idx);
         NumberSet cands = tracker_cell.candidates;
 
         for (Number n: cands) {
             if (!this->set_cell(idx, n)) {
-                tracker_cell.candidates.remove(n);
+                tracker_cell.remove_candidate(n);
                 cell.remove_candidate(n);
                 continue;
             }
 
             SolverStats local_stats;
-            std::vector<Solution> boards = this->solve(1, max_nodes, &local_stats);
+            const CellMask *scope = scopes.empty() ? nullptr : &scopes[flat_index(idx)];
+            std::optional<Solution> found = solve_scope(scope, rest, max_nodes, local_stats);
             nodes_explored += local_stats.nodes_explored;
 
-            if (!boards.empty()) {
-                Solution sol = boards[0];
+            if (found) {
+                const Solution &sol = *found;
                 std::ostringstream oss;
                 oss << sol;
                 const std::string key = oss.str();
@@ -65,14 +94,12 @@ std::vector<Solution> Board::solve_complete(SolverStats *stats_out, int max_node
                 for (Row r = 0; r < board_size_; ++r) {
                     for (Col c = 0; c < board_size_; ++c) {
                         Number solved_value = sol.get(r, c);
-                        Cell &tracker_cell = tracker.get_cell({r, c});
-                        if (tracker_cell.candidates.test(solved_value))
-                            tracker_cell.candidates.remove(solved_value);
+                        tracker->get_cell({r, c}).remove_candidate(solved_value);
                     }
                 }
             } else if (!local_stats.interrupted_by_node_limit) {
-                tracker_cell.candidates.remove(n);
-                cell.candidates.remove(n);
+                tracker_cell.remove_candidate(n);
+                cell.remove_candidate(n);
             }
 
             this->pop_history();
@@ -88,7 +115,9 @@ std::vector<Solution> Board::solve_complete(SolverStats *stats_out, int max_node
     if (stats_out) {
         stats_out->solutions_found = static_cast<int>(all_solutions.size());
         stats_out->nodes_explored = nodes_explored;
+        stats_out->handler_calls = handler_calls_ - handler_calls;
         stats_out->time_taken_ms = elapsed_ms;
+        stats_out->allocations = alloc_counter::count() - allocations;
         stats_out->interrupted_by_node_limit = false;
         stats_out->interrupted_by_solution_limit = false;
     }
@@ -97,130 +126,424 @@ std::vector<Solution> Board::solve_complete(SolverStats *stats_out, int max_node
 }
 
 
-std::vector<Solution> Board::solve(int max_solutions, int max_nodes, SolverStats *stats_out) {
-    std::vector<Solution> solutions;
-    int nodes_explored = 0;
-    int guesses_made = 0;
-    bool interrupted_by_node_limit = false;
-    bool interrupted_by_solution_limit = false;
-
-    const auto start_time = std::chrono::steady_clock::now();
+template<typename OnSolution>
+void Board::search(int max_nodes, SolverStats &stats, const CellMask *scope, OnSolution &&on_solution) {
     update_impact_map();
+    reset_failure_map();
+
+    // Each frame is one decision: the cell being branched on, the candidates that still have to be
+    // tried, and the history depth to return to before trying the next one.
+    struct Frame {
+        CellIdx pos;
+        NumberSet remaining;
+        int mark;
+    };
+    std::vector<Frame> frames;
+    frames.reserve(board_size_ * board_size_ + 1);
 
-    std::function<bool()> backtrack = [&]() {
-        if (++nodes_explored > max_nodes) {
-            interrupted_by_node_limit = true;
+    // Visits the current node. Returns false if the search must stop.
+    auto enter = [&]() {
+        if (++stats.nodes_explored > max_nodes) {
+            stats.interrupted_by_node_limit = true;
             return false;
         }
 
-        if (is_solved()) {
-            solutions.push_back(copy_solution());
-            if (static_cast<int>(solutions.size()) >= max_solutions) {
-                interrupted_by_solution_limit = true;
-                return false;
-            }
-            return true;
+        if (scope ? !(unsolved_mask() & *scope).any() : is_solved()) {
+            ++stats.solutions_found;
+            return on_solution();
         }
 
-        const CellIdx pos = get_next_cell();
+        const CellIdx pos = get_next_cell(scope);
         const Cell &cell = get_cell(pos);
 
         // Count as a guess if more than one candidate
         if (cell.candidates.count() > 1) {
-            ++guesses_made;
+            ++stats.guesses_made;
         }
 
-        for (Number n: cell.candidates) {
-            if (set_cell(pos, n)) {
-                bool keep_going = backtrack();
-                pop_history();
-                if (!keep_going)
-                    return false;
+        frames.push_back({pos, cell.candidates, history_depth()});
+        return true;
+    };
+
+    const int base_depth = history_depth();
+
+    // restarts only happen before the first solution, so no solution is reported twice
+    int run_budget = restart_unit_ * luby(1);
+    int run_start = 0;
+    auto restart_due = [&]() {
+        return restart_unit_ > 0 && stats.solutions_found == 0 && stats.nodes_explored - run_start >= run_budget;
+    };
+
+    // set_cell() only checks the constraints touching the cells a placement modified, so the
+    // starting state is checked in full once
+    if (valid() && enter()) {
+        while (!frames.empty()) {
+            if (restart_due()) {
+                restore_history(base_depth);
+                frames.clear();
+                ++stats.restarts;
+                run_budget = restart_unit_ * luby(stats.restarts + 1);
+                run_start = stats.nodes_explored;
+                if (!enter())
+                    break;
+                continue;
             }
+
+            Frame &frame = frames.back();
+            restore_history(frame.mark);
+
+            if (frame.remaining.count() == 0) {
+                frames.pop_back();
+                continue;
+            }
+
+            const Number n = frame.remaining.lowest();
+            frame.remaining.remove(n);
+
+            if (set_cell(frame.pos, n) && !enter())
+                break;
         }
+    }
 
+    restore_history(base_depth);
+}
+
+std::optional<Solution> Board::solve_scope(const CellMask *scope, const Solution &rest, int max_nodes,
+                                           SolverStats &stats) {
+    std::optional<Solution> found;
+    search(max_nodes, stats, scope, [&]() {
+        found = copy_solution();
+        if (scope)
+            for (int idx = 0; idx < cell_count_; ++idx)
+                if (!scope->test(idx) && values_[idx] == EMPTY)
+                    found->set(idx / board_size_, idx % board_size_, rest.get(idx / board_size_, idx % board_size_));
+        return false;
+    });
+    return found;
+}
+
+std::vector<CellMask> Board::split_for_probes(Solution &rest, int max_nodes, int &nodes_explored) {
+    const std::vector<CellMask> parts = components(unsolved_mask());
+    if (parts.size() < 2)
+        return {};
+
+    // one solution of every component, to complete the solutions found by the probes of the others
+    rest = copy_solution();
+    std::vector<CellMask> scopes(cell_count_);
+    for (const CellMask &part: parts) {
+        SolverStats stats;
+        std::optional<Solution> found = solve_scope(&part, rest, max_nodes, stats);
+        nodes_explored += stats.nodes_explored;
+        if (!found)
+            return {}; // unsolvable or out of budget, probe the whole board instead
+
+        for (int idx: part) {
+            rest.set(idx / board_size_, idx % board_size_, found->get(idx / board_size_, idx % board_size_));
+            scopes[idx] = part;
+        }
+    }
+    return scopes;
+}
+
+std::vector<Solution> Board::solve(int max_solutions, int max_nodes, SolverStats *stats_out) {
+    std::vector<Solution> solutions;
+    SolverStats stats;
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    search(max_nodes, stats, nullptr, [&]() {
+        solutions.push_back(copy_solution());
+        if (static_cast<int>(solutions.size()) >= max_solutions) {
+            stats.interrupted_by_solution_limit = true;
+            return false;
+        }
         return true;
-    };
+    });
+
+    const auto end_time = std::chrono::steady_clock::now();
+    stats.time_taken_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+    stats.handler_calls = handler_calls_ - handler_calls;
+    stats.allocations = alloc_counter::count() - allocations;
 
-    backtrack();
+    if (stats_out)
+        *stats_out = stats;
+
+    return solutions;
+}
+
+const char *uniqueness_name(Uniqueness uniqueness) {
+    switch (uniqueness) {
+        case Uniqueness::None:
+            return "none";
+        case Uniqueness::Unique:
+            return "unique";
+        case Uniqueness::Multiple:
+            return "multiple";
+        case Uniqueness::Unknown:
+            break;
+    }
+    return "unknown";
+}
+
+UniquenessResult Board::check_unique(int max_nodes, SolverStats *stats_out) {
+    UniquenessResult result;
+    SolverStats stats;
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // the frames of the first solution still hold their untried candidates, so continuing the
+    // search from there only explores branches that differ from it
+    search(max_nodes, stats, nullptr, [&]() {
+        if (stats.solutions_found > 1) {
+            stats.interrupted_by_solution_limit = true;
+            return false;
+        }
+        result.solution = copy_solution();
+        return true;
+    });
+
+    if (stats.solutions_found > 1) {
+        result.status = Uniqueness::Multiple;
+        result.solution.reset();
+    } else if (stats.interrupted_by_node_limit) {
+        result.status = Uniqueness::Unknown;
+        result.solution.reset();
+    } else {
+        result.status = stats.solutions_found == 1 ? Uniqueness::Unique : Uniqueness::None;
+    }
 
     const auto end_time = std::chrono::steady_clock::now();
-    float elapsed_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+    stats.time_taken_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+    stats.handler_calls = handler_calls_ - handler_calls;
+    stats.allocations = alloc_counter::count() - allocations;
 
-    if (stats_out) {
-        *stats_out = SolverStats{.solutions_found = static_cast<int>(solutions.size()),
-                                 .nodes_explored = nodes_explored,
-                                 .guesses_made = guesses_made,
-                                 .time_taken_ms = elapsed_ms,
-                                 .interrupted_by_node_limit = interrupted_by_node_limit,
-                                 .interrupted_by_solution_limit = interrupted_by_solution_limit};
+    if (stats_out)
+        *stats_out = stats;
+
+    return result;
+}
+
+uint64_t Board::count_solutions(uint64_t limit, int max_nodes, SolverStats *stats_out) {
+    uint64_t count = 0;
+    SolverStats stats;
+    const int handler_calls = handler_calls_;
+    const uint64_t allocations = alloc_counter::count();
+
+    const auto start_time = std::chrono::steady_clock::now();
+    update_impact_map();
+    reset_failure_map();
+
+    CountState state{limit, max_nodes, stats};
+    if (limit > 0 && valid()) {
+        ++stats.nodes_explored;
+        count = count_scope(unsolved_mask(), state);
     }
 
-    return solutions;
+    const auto end_time = std::chrono::steady_clock::now();
+    stats.solutions_found = static_cast<int>(std::min<uint64_t>(count, std::numeric_limits<int>::max()));
+    stats.interrupted_by_solution_limit = limit > 0 && count >= limit;
+    stats.time_taken_ms = std::chrono::duration<float, std::milli>(end_time - start_time).count();
+    stats.handler_calls = handler_calls_ - handler_calls;
+    stats.allocations = alloc_counter::count() - allocations;
+
+    if (stats_out)
+        *stats_out = stats;
+
+    return count;
 }
 
-CellIdx Board::get_next_cell() const {
-    int min_candidates = board_size_ + 1;
-    int max_impact = -1;
-    std::vector<const Cell *> best_cells;
+uint64_t Board::count_scope(const CellMask &scope, CountState &state) {
+    CellMask open = unsolved_mask() & scope;
+    uint64_t count = 1;
+    while (open.any()) {
+        // components share no constraint group, so their completions combine freely
+        const CellMask component = component_of(open.lowest(), open);
+        const uint64_t completions = count_component(component, state);
+        if (completions == 0)
+            return 0;
+
+        count = count > state.limit / completions ? state.limit : count * completions;
+        if (state.stats.interrupted_by_node_limit)
+            break;
+        open -= component;
+    }
+    return count;
+}
 
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            const Cell &cell = grid_[r][c];
-            if (cell.value != EMPTY)
-                continue;
+uint64_t Board::count_component(const CellMask &component, CountState &state) {
+    const CellIdx pos = get_next_cell(&component);
+    const NumberSet candidates = get_cell(pos).candidates;
+    if (candidates.count() > 1)
+        ++state.stats.guesses_made;
 
-            int count = cell.candidates.count();
-            if (count < min_candidates) {
-                min_candidates = count;
-                best_cells.clear();
-                best_cells.push_back(&cell);
-                max_impact = get_impact(cell.pos);
-            } else if (count == min_candidates) {
-                int impact = get_impact(cell.pos);
-                if (impact > max_impact) {
-                    best_cells.clear();
-                    best_cells.push_back(&cell);
-                    max_impact = impact;
-                } else if (impact == max_impact) {
-                    best_cells.push_back(&cell);
-                }
+    uint64_t count = 0;
+    for (Number n: candidates) {
+        if (!set_cell(pos, n))
+            continue;
+        if (++state.stats.nodes_explored > state.max_nodes) {
+            state.stats.interrupted_by_node_limit = true;
+            pop_history();
+            break;
+        }
+
+        const uint64_t completions = count_scope(component, state);
+        pop_history();
+
+        count = completions < state.limit - count ? count + completions : state.limit;
+        if (count >= state.limit || state.stats.interrupted_by_node_limit)
+            break;
+    }
+    return count;
+}
+
+CellMask Board::unsolved_mask() const {
+    CellMask res;
+    for (const CellMask &bucket: candidate_buckets_)
+        res |= bucket;
+    return res;
+}
+
+CellMask Board::component_of(int idx, const CellMask &cells) const {
+    CellMask reached;
+    reached.set(idx);
+    CellMask frontier = reached;
+    while (frontier.any()) {
+        CellMask next;
+        for (int k: frontier)
+            next |= neighbours_[k];
+        frontier = (next & cells) - reached;
+        reached |= frontier;
+    }
+    return reached;
+}
+
+std::vector<CellMask> Board::components(CellMask cells) const {
+    std::vector<CellMask> res;
+    while (cells.any()) {
+        res.push_back(component_of(cells.lowest(), cells));
+        cells -= res.back();
+    }
+    return res;
+}
+
+CellIdx Board::get_next_cell(const CellMask *scope) const {
+    if (heuristic_ == BranchHeuristic::Weighted)
+        return get_next_cell_weighted(scope);
+
+    // the first non-empty bucket holds the unsolved cells with the fewest candidates
+    for (int count = 0; count <= board_size_; ++count) {
+        const CellMask bucket = scope ? candidate_buckets_[count] & *scope : candidate_buckets_[count];
+        if (!bucket.any())
+            continue;
+
+        int max_impact = -1;
+        int ties = 0;
+        for (int idx: bucket) {
+            int impact = impact_map_.get({idx / board_size_, idx % board_size_});
+            if (impact > max_impact) {
+                max_impact = impact;
+                ties = 1;
+            } else if (impact == max_impact) {
+                ++ties;
             }
         }
+
+        int pick = std::uniform_int_distribution<int>(0, ties - 1)(rng_);
+        for (int idx: bucket) {
+            const CellIdx pos{idx / board_size_, idx % board_size_};
+            if (impact_map_.get(pos) == max_impact && pick-- == 0)
+                return pos;
+        }
     }
 
-    if (best_cells.empty())
-        throw std::runtime_error("No empty cell found");
+    throw std::runtime_error("No empty cell found");
+}
+
+CellIdx Board::get_next_cell_weighted(const CellMask *scope) const {
+    // a cell with a single candidate costs no branching, take it before weighing anything
+    const CellMask singles = scope ? candidate_buckets_[1] & *scope : candidate_buckets_[1];
+    if (singles.any()) {
+        const int idx = singles.lowest();
+        return {idx / board_size_, idx % board_size_};
+    }
+
+    // minimize count / weight, compared as count * best_weight < best_count * weight;
+    // equal scores are broken by the static impact
+    int best_idx = -1;
+    long best_count = 0;
+    long best_weight = 1;
+    int best_impact = -1;
+    for (int count = 2; count <= board_size_; ++count) {
+        const CellMask bucket = scope ? candidate_buckets_[count] & *scope : candidate_buckets_[count];
+        for (int idx: bucket) {
+            const CellIdx pos{idx / board_size_, idx % board_size_};
+            const long weight = FAILURE_WEIGHT + failure_map_.get(pos);
+            const long lhs = count * best_weight;
+            const long rhs = best_count * weight;
+            if (best_idx >= 0 && lhs > rhs)
+                continue;
+
+            const int impact = impact_map_.get(pos);
+            if (best_idx >= 0 && lhs == rhs && impact <= best_impact)
+                continue;
+
+            best_idx = idx;
+            best_count = count;
+            best_weight = weight;
+            best_impact = impact;
+        }
+    }
 
-    const Cell *chosen = best_cells[rand() % best_cells.size()];
-    return chosen->pos;
+    if (best_idx < 0)
+        throw std::runtime_error("No empty cell found");
+    return {best_idx / board_size_, best_idx % board_size_};
 }
 
 sudoku::Solution Board::copy_solution() const {
     Solution sol(board_size_);
     for (Row r = 0; r < board_size_; ++r) {
         for (Col c = 0; c < board_size_; ++c) {
-            sol.set(r, c, grid_[r][c].value);
+            sol.set(r, c, values_[r * board_size_ + c]);
         }
     }
     return sol;
 }
 
-Board Board::clone_shallow() const {
-    Board res{board_size_};
+std::unique_ptr<Board> Board::clone_shallow() const {
+    auto res = std::make_unique<Board>(board_size_);
 
-    // Copy cell values and candidates
-    for (Row r = 0; r < board_size_; ++r) {
-        for (Col c = 0; c < board_size_; ++c) {
-            res.grid_[r][c].value = grid_[r][c].value;
-            res.grid_[r][c].candidates = grid_[r][c].candidates;
-        }
-    }
+    // the whole cell state lives in two flat arrays, copying them is a plain memcpy
+    std::copy_n(values_.begin(), cell_count_, res->values_.begin());
+    std::copy_n(candidates_.begin(), cell_count_, res->candidates_.begin());
+
+    res->index_cells();
 
     // no copying of handlers!
 
     return res;
 }
 
+std::unique_ptr<Board> Board::clone() const {
+    auto res = clone_shallow();
+
+    for (const auto &handler: handlers_)
+        res->handlers_.push_back(handler->clone(res.get()));
+    res->index_handlers();
+
+    res->impact_map_ = impact_map_;
+    res->failure_map_ = failure_map_;
+    res->failures_ = failures_;
+    res->use_smart_hints_ = use_smart_hints_;
+    res->heuristic_ = heuristic_;
+    res->restart_unit_ = restart_unit_;
+    res->seed_ = seed_;
+    res->rng_ = rng_;
+    return res;
+}
+
 
 }; // namespace sudoku
@@ -0,0 +1,195 @@
+/**
+ * @file digit_board.h
+ * @brief Per-digit bitboards mirroring the candidates of all cells.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * For every digit the board keeps one 128-bit mask with a bit per cell that still allows the
+ * digit, plus one mask of solved cells. Unit and peer questions of the standard rules then become
+ * a few AND/OR/popcount operations, done with SSE (native builds) or SIMD128 (WASM builds) where
+ * available. The masks are updated by the Board whenever a cell changes, so they always agree
+ * with the Cell view used by all other rules.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#include "../number_set.h"
+#include "geometry.h"
+
+namespace sudoku {
+
+/**
+ * @struct Bits128
+ * @brief 128-bit cell mask. Bit i is the cell with flat index i.
+ */
+struct alignas(16) Bits128 {
+    uint64_t w[2] = {0, 0};
+
+    static Bits128 single(int idx) {
+        Bits128 res;
+        res.w[idx >> 6] = uint64_t{1} << (idx & 63);
+        return res;
+    }
+
+    void set(int idx) { w[idx >> 6] |= uint64_t{1} << (idx & 63); }
+
+    /// Sets or clears a bit without branching
+    void assign(int idx, bool on) {
+        const uint64_t bit = uint64_t{1} << (idx & 63);
+        uint64_t &word = w[idx >> 6];
+        word = (word & ~bit) | (bit & -static_cast<uint64_t>(on));
+    }
+
+    bool test(int idx) const { return w[idx >> 6] >> (idx & 63) & 1; }
+
+    int count() const { return std::popcount(w[0]) + std::popcount(w[1]); }
+
+    /// Calls `f` with the index of every set bit in ascending order
+    template<typename F>
+    void for_each(F &&f) const {
+        for (int i = 0; i < 2; ++i)
+            for (uint64_t bits = w[i]; bits; bits &= bits - 1)
+                f(i * 64 + std::countr_zero(bits));
+    }
+
+#if defined(__SSE2__)
+    static Bits128 from(__m128i v) {
+        Bits128 res;
+        _mm_store_si128(reinterpret_cast<__m128i *>(res.w), v);
+        return res;
+    }
+    __m128i load() const { return _mm_load_si128(reinterpret_cast<const __m128i *>(w)); }
+
+    Bits128 operator&(const Bits128 &o) const { return from(_mm_and_si128(load(), o.load())); }
+    Bits128 operator|(const Bits128 &o) const { return from(_mm_or_si128(load(), o.load())); }
+    /// Bits of this mask that are not set in `o`
+    Bits128 operator-(const Bits128 &o) const { return from(_mm_andnot_si128(o.load(), load())); }
+
+#if defined(__SSE4_1__)
+    bool any() const { return !_mm_testz_si128(load(), load()); }
+    /// True if the masks share a bit, without materializing the intersection
+    bool intersects(const Bits128 &o) const { return !_mm_testz_si128(load(), o.load()); }
+#else
+    bool any() const { return _mm_movemask_epi8(_mm_cmpeq_epi8(load(), _mm_setzero_si128())) != 0xFFFF; }
+    bool intersects(const Bits128 &o) const { return (*this & o).any(); }
+#endif
+
+#elif defined(__wasm_simd128__)
+    static Bits128 from(v128_t v) {
+        Bits128 res;
+        wasm_v128_store(res.w, v);
+        return res;
+    }
+    v128_t load() const { return wasm_v128_load(w); }
+
+    Bits128 operator&(const Bits128 &o) const { return from(wasm_v128_and(load(), o.load())); }
+    Bits128 operator|(const Bits128 &o) const { return from(wasm_v128_or(load(), o.load())); }
+    Bits128 operator-(const Bits128 &o) const { return from(wasm_v128_andnot(load(), o.load())); }
+
+    bool any() const { return wasm_v128_any_true(load()); }
+    bool intersects(const Bits128 &o) const { return wasm_v128_any_true(wasm_v128_and(load(), o.load())); }
+
+#else
+    Bits128 operator&(const Bits128 &o) const { return {{w[0] & o.w[0], w[1] & o.w[1]}}; }
+    Bits128 operator|(const Bits128 &o) const { return {{w[0] | o.w[0], w[1] | o.w[1]}}; }
+    Bits128 operator-(const Bits128 &o) const { return {{w[0] & ~o.w[0], w[1] & ~o.w[1]}}; }
+
+    bool any() const { return (w[0] | w[1]) != 0; }
+    bool intersects(const Bits128 &o) const { return ((w[0] & o.w[0]) | (w[1] & o.w[1])) != 0; }
+#endif
+
+    Bits128 &operator|=(const Bits128 &o) { return *this = *this | o; }
+};
+
+/**
+ * @class DigitBoard
+ * @brief Candidate positions of every digit as 128-bit masks, for boards with at most 128 cells.
+ */
+class DigitBoard {
+public:
+    static constexpr int MAX_CELLS = 128;
+    static constexpr int MAX_DIGITS = 11; ///< Largest size with size * size <= MAX_CELLS
+    static constexpr int MAX_UNITS = 3 * MAX_DIGITS;
+
+    /**
+     * @brief Returns true if a board of this size fits into the masks.
+     */
+    static constexpr bool supports(int size) { return size * size <= MAX_CELLS; }
+
+    /**
+     * @brief Builds the unit and peer masks of a board geometry. All cells start without candidates.
+     */
+    explicit DigitBoard(const GeometryView &geometry) : size_(geometry.size), units_(geometry.units) {
+        for (int u = 0; u < units_; ++u) {
+            const auto *cells = geometry.unit(u);
+            for (int i = 0; i < size_; ++i)
+                unit_masks_[u].set(cells[i]);
+        }
+        for (int idx = 0; idx < size_ * size_; ++idx) {
+            const auto *peers = geometry.peers_of(idx);
+            for (int i = 0; i < geometry.peers; ++i)
+                peer_masks_[idx].set(peers[i]);
+        }
+    }
+
+    /**
+     * @brief Mirrors the state of a cell.
+     */
+    void update(int idx, Number value, const NumberSet &candidates) {
+        const auto bits = candidates.raw();
+        for (int d = 0; d < size_; ++d)
+            digits_[d].assign(idx, bits >> d & 1);
+        solved_.assign(idx, value != EMPTY);
+    }
+
+    /// Cells that still allow a digit (solved cells allow exactly their value)
+    const Bits128 &digit(Number d) const { return digits_[d - 1]; }
+
+    /// Cells with a value
+    const Bits128 &solved() const { return solved_; }
+
+    /// Cells of a unit (numbered as in GeometryView)
+    const Bits128 &unit(int u) const { return unit_masks_[u]; }
+
+    /// Cells sharing a unit with a cell
+    const Bits128 &peers(int idx) const { return peer_masks_[idx]; }
+
+    /**
+     * @brief A unit is valid if every digit has a candidate position and no digit is placed twice.
+     */
+    bool unit_valid(int u) const {
+        const Bits128 &unit = unit_masks_[u];
+        const Bits128 solved = solved_ & unit;
+        for (int d = 0; d < size_; ++d) {
+            if (!digits_[d].intersects(unit))
+                return false;
+            if ((digits_[d] & solved).count() > 1)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    int size_;
+    int units_;
+    std::array<Bits128, MAX_DIGITS> digits_{}; ///< Candidate positions per digit
+    Bits128 solved_{}; ///< Solved cells
+    std::array<Bits128, MAX_UNITS> unit_masks_{}; ///< Cells of every unit
+    std::array<Bits128, MAX_CELLS> peer_masks_{}; ///< Peers of every cell
+};
+
+} // namespace sudoku
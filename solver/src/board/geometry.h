@@ -0,0 +1,233 @@
+/**
+ * @file geometry.h
+ * @brief Compile-time unit and peer tables for the supported board sizes.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * The rows, columns, blocks, peers and block/line intersections of a board only depend on its
+ * size, so they are computed at compile time for every supported size (4, 6, 9 and 16). Hot
+ * loops can be instantiated for a fixed size through dispatch_size(); everything else reads the
+ * same tables through a GeometryView.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "../number_set.h"
+
+namespace sudoku {
+
+/**
+ * @struct GeometryView
+ * @brief Size-erased view of the tables of a Geometry.
+ *
+ * Cells are addressed by their flat index r * size + c. Units are numbered rows first, then
+ * columns, then blocks.
+ */
+struct GeometryView {
+    using index_t = uint8_t;
+
+    static constexpr index_t NO_UNIT = 0xFF; ///< Block of a cell on a board without blocks
+
+    int size; ///< Board size N
+    int block_size; ///< Block dimension (floor(sqrt(N)))
+    bool has_blocks; ///< True if N is a square number
+    int units; ///< Number of units (rows, columns and blocks)
+    int peers; ///< Number of peers of every cell
+    const index_t *unit_cells; ///< units x size table of flat cell indices
+    const index_t *cell_units; ///< (size * size) x 3 table of row, column and block unit of every cell
+    const index_t *peer_cells; ///< (size * size) x peers table of flat cell indices
+
+    /// Flat indices of the cells of a unit
+    const index_t *unit(int u) const { return unit_cells + u * size; }
+
+    /// Row, column and block unit of a cell (the block is NO_UNIT without blocks)
+    const index_t *units_of(int idx) const { return cell_units + idx * 3; }
+
+    /// Flat indices of the cells sharing a unit with a cell
+    const index_t *peers_of(int idx) const { return peer_cells + idx * peers; }
+};
+
+/**
+ * @struct Geometry
+ * @brief Rows, columns, blocks and peers of an N x N board, computed at compile time.
+ *
+ * Blocks only exist if N is a square number.
+ */
+template<int N>
+struct Geometry {
+    using index_t = GeometryView::index_t;
+
+    static_assert(N >= 1 && N <= MAX_SIZE, "Unsupported board size");
+
+    static constexpr int SIZE = N;
+    static constexpr int CELLS = N * N;
+    static constexpr int BLOCK = [] {
+        int b = 1;
+        while ((b + 1) * (b + 1) <= N)
+            ++b;
+        return b;
+    }();
+    static constexpr bool HAS_BLOCKS = BLOCK * BLOCK == N;
+    static constexpr int UNITS = HAS_BLOCKS ? 3 * N : 2 * N;
+    static constexpr int PEERS = 2 * (N - 1) + (HAS_BLOCKS ? (BLOCK - 1) * (BLOCK - 1) : 0);
+    static constexpr NumberSet::bit_t MASK = NumberSet::mask(N);
+
+    static constexpr int row_unit(int r) { return r; }
+    static constexpr int col_unit(int c) { return N + c; }
+    static constexpr int block_unit(int b) { return 2 * N + b; }
+    static constexpr int block_of(int r, int c) { return (r / BLOCK) * BLOCK + c / BLOCK; }
+
+    /// Flat indices of the cells of every unit
+    static constexpr std::array<std::array<index_t, N>, UNITS> units = [] {
+        std::array<std::array<index_t, N>, UNITS> res{};
+        std::array<int, UNITS> fill{};
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                const auto idx = static_cast<index_t>(r * N + c);
+                res[row_unit(r)][fill[row_unit(r)]++] = idx;
+                res[col_unit(c)][fill[col_unit(c)]++] = idx;
+                if (HAS_BLOCKS)
+                    res[block_unit(block_of(r, c))][fill[block_unit(block_of(r, c))]++] = idx;
+            }
+        }
+        return res;
+    }();
+
+    /// Row, column and block unit of every cell
+    static constexpr std::array<std::array<index_t, 3>, CELLS> cell_units = [] {
+        std::array<std::array<index_t, 3>, CELLS> res{};
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                res[r * N + c] = {static_cast<index_t>(row_unit(r)), static_cast<index_t>(col_unit(c)),
+                                  HAS_BLOCKS ? static_cast<index_t>(block_unit(block_of(r, c))) : GeometryView::NO_UNIT};
+            }
+        }
+        return res;
+    }();
+
+    /// Cells sharing a row, column or block with every cell: row, then column, then the rest of the block
+    static constexpr std::array<std::array<index_t, PEERS>, CELLS> peers = [] {
+        std::array<std::array<index_t, PEERS>, CELLS> res{};
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                auto &list = res[r * N + c];
+                int n = 0;
+                for (int i = 0; i < N; ++i)
+                    if (i != c)
+                        list[n++] = static_cast<index_t>(r * N + i);
+                for (int i = 0; i < N; ++i)
+                    if (i != r)
+                        list[n++] = static_cast<index_t>(i * N + c);
+                if (HAS_BLOCKS) {
+                    const int br = (r / BLOCK) * BLOCK;
+                    const int bc = (c / BLOCK) * BLOCK;
+                    for (int i = br; i < br + BLOCK; ++i)
+                        for (int j = bc; j < bc + BLOCK; ++j)
+                            if (i != r && j != c)
+                                list[n++] = static_cast<index_t>(i * N + j);
+                }
+            }
+        }
+        return res;
+    }();
+
+    /// Cells of block b in its k-th row, left to right
+    static constexpr std::array<std::array<std::array<index_t, BLOCK>, BLOCK>, N> box_rows = [] {
+        std::array<std::array<std::array<index_t, BLOCK>, BLOCK>, N> res{};
+        if (HAS_BLOCKS)
+            for (int b = 0; b < N; ++b)
+                for (int k = 0; k < BLOCK; ++k)
+                    for (int j = 0; j < BLOCK; ++j)
+                        res[b][k][j] = static_cast<index_t>(((b / BLOCK) * BLOCK + k) * N + (b % BLOCK) * BLOCK + j);
+        return res;
+    }();
+
+    /// Cells of block b in its k-th column, top to bottom
+    static constexpr std::array<std::array<std::array<index_t, BLOCK>, BLOCK>, N> box_cols = [] {
+        std::array<std::array<std::array<index_t, BLOCK>, BLOCK>, N> res{};
+        if (HAS_BLOCKS)
+            for (int b = 0; b < N; ++b)
+                for (int k = 0; k < BLOCK; ++k)
+                    for (int j = 0; j < BLOCK; ++j)
+                        res[b][k][j] = static_cast<index_t>(((b / BLOCK) * BLOCK + j) * N + (b % BLOCK) * BLOCK + k);
+        return res;
+    }();
+
+    /// Cells of the k-th row of block b that lie outside the block
+    static constexpr std::array<std::array<std::array<index_t, N - BLOCK>, BLOCK>, N> row_rest = [] {
+        std::array<std::array<std::array<index_t, N - BLOCK>, BLOCK>, N> res{};
+        if (HAS_BLOCKS)
+            for (int b = 0; b < N; ++b)
+                for (int k = 0; k < BLOCK; ++k) {
+                    const int r = (b / BLOCK) * BLOCK + k;
+                    int n = 0;
+                    for (int c = 0; c < N; ++c)
+                        if (c / BLOCK != b % BLOCK)
+                            res[b][k][n++] = static_cast<index_t>(r * N + c);
+                }
+        return res;
+    }();
+
+    /// Cells of the k-th column of block b that lie outside the block
+    static constexpr std::array<std::array<std::array<index_t, N - BLOCK>, BLOCK>, N> col_rest = [] {
+        std::array<std::array<std::array<index_t, N - BLOCK>, BLOCK>, N> res{};
+        if (HAS_BLOCKS)
+            for (int b = 0; b < N; ++b)
+                for (int k = 0; k < BLOCK; ++k) {
+                    const int c = (b % BLOCK) * BLOCK + k;
+                    int n = 0;
+                    for (int r = 0; r < N; ++r)
+                        if (r / BLOCK != b / BLOCK)
+                            res[b][k][n++] = static_cast<index_t>(r * N + c);
+                }
+        return res;
+    }();
+
+    static GeometryView view() {
+        return {N,           BLOCK,           HAS_BLOCKS,           UNITS, PEERS, units[0].data(),
+                cell_units[0].data(), peers[0].data()};
+    }
+};
+
+static_assert(Geometry<9>::PEERS == 20 && Geometry<9>::peers[0][19] == 20);
+static_assert(Geometry<9>::box_cols[4][2][1] == 41 && Geometry<9>::row_rest[4][0][3] == 33);
+static_assert(!Geometry<6>::HAS_BLOCKS && Geometry<6>::UNITS == 12);
+
+/**
+ * @brief Calls `f` with the Geometry instance of the given board size.
+ *
+ * This is the single place where a runtime size is turned into a compile-time one.
+ * @throws std::runtime_error if the size is not supported
+ */
+template<typename F>
+decltype(auto) dispatch_size(int size, F &&f) {
+    switch (size) {
+        case 4:
+            return f(Geometry<4>{});
+        case 6:
+            return f(Geometry<6>{});
+        case 9:
+            return f(Geometry<9>{});
+        case 16:
+            return f(Geometry<16>{});
+        default:
+            throw std::runtime_error("Unsupported board size: " + std::to_string(size));
+    }
+}
+
+/**
+ * @brief Returns the tables of the given board size.
+ * @throws std::runtime_error if the size is not supported
+ */
+inline GeometryView geometry_for(int size) {
+    return dispatch_size(size, [](auto geometry) { return decltype(geometry)::view(); });
+}
+
+} // namespace sudoku
@@ -0,0 +1,228 @@
+/**
+ * @file singles.h
+ * @brief Batched hidden/naked single detection over all units of a board.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * The candidate masks of a board are stored row by row, so one vector load covers a whole row
+ * (up to 16 cells). Accumulating the rows lane by lane gives the seen-once/seen-twice masks of
+ * every column and every block band at the same time; the rows are folded separately. The result
+ * is a mask of the cells whose value is forced, together with the forced digits. AVX2 (16 lanes),
+ * SSE2 or WASM SIMD128 (8 lanes) are used where available, otherwise the lanes are scalar.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#include "../cell_mask.h"
+#include "../number_set.h"
+#include "geometry.h"
+
+namespace sudoku {
+
+static_assert(sizeof(NumberSet) == sizeof(NumberSet::bit_t), "Candidate arrays are loaded as raw masks");
+
+/**
+ * @struct Singles
+ * @brief Forced placements found by find_singles().
+ */
+struct Singles {
+    CellMask cells; ///< Unsolved cells whose value is forced
+    std::array<NumberSet, MAX_SIZE * MAX_SIZE> digits; ///< Forced digit of every cell in `cells`
+    bool conflict = false; ///< Some cell is the only place left for two different digits
+};
+
+namespace singles_detail {
+
+using bit_t = NumberSet::bit_t;
+
+/**
+ * @struct Lanes
+ * @brief A vector of 16-bit candidate masks, one lane per column.
+ */
+#if defined(__AVX2__)
+struct Lanes {
+    static constexpr int WIDTH = 16;
+    __m256i v;
+
+    static Lanes zero() { return {_mm256_setzero_si256()}; }
+    static Lanes splat(bit_t bits) { return {_mm256_set1_epi16(static_cast<short>(bits))}; }
+    static Lanes load(const void *p) { return {_mm256_loadu_si256(static_cast<const __m256i *>(p))}; }
+    void store(bit_t *p) const { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+    Lanes operator&(Lanes o) const { return {_mm256_and_si256(v, o.v)}; }
+    Lanes operator|(Lanes o) const { return {_mm256_or_si256(v, o.v)}; }
+};
+#elif defined(__SSE2__)
+struct Lanes {
+    static constexpr int WIDTH = 8;
+    __m128i v;
+
+    static Lanes zero() { return {_mm_setzero_si128()}; }
+    static Lanes splat(bit_t bits) { return {_mm_set1_epi16(static_cast<short>(bits))}; }
+    static Lanes load(const void *p) { return {_mm_loadu_si128(static_cast<const __m128i *>(p))}; }
+    void store(bit_t *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+    Lanes operator&(Lanes o) const { return {_mm_and_si128(v, o.v)}; }
+    Lanes operator|(Lanes o) const { return {_mm_or_si128(v, o.v)}; }
+};
+#elif defined(__wasm_simd128__)
+struct Lanes {
+    static constexpr int WIDTH = 8;
+    v128_t v;
+
+    static Lanes zero() { return {wasm_i16x8_splat(0)}; }
+    static Lanes splat(bit_t bits) { return {wasm_i16x8_splat(static_cast<int16_t>(bits))}; }
+    static Lanes load(const void *p) { return {wasm_v128_load(p)}; }
+    void store(bit_t *p) const { wasm_v128_store(p, v); }
+
+    Lanes operator&(Lanes o) const { return {wasm_v128_and(v, o.v)}; }
+    Lanes operator|(Lanes o) const { return {wasm_v128_or(v, o.v)}; }
+};
+#else
+struct Lanes {
+    static constexpr int WIDTH = 1;
+    bit_t v;
+
+    static Lanes zero() { return {0}; }
+    static Lanes splat(bit_t bits) { return {bits}; }
+    static Lanes load(const void *p) {
+        bit_t bits;
+        std::memcpy(&bits, p, sizeof(bits));
+        return {bits};
+    }
+    void store(bit_t *p) const { *p = v; }
+
+    Lanes operator&(Lanes o) const { return {static_cast<bit_t>(v & o.v)}; }
+    Lanes operator|(Lanes o) const { return {static_cast<bit_t>(v | o.v)}; }
+};
+#endif
+
+} // namespace singles_detail
+
+/**
+ * @brief Finds every forced placement of a board in one pass over all units.
+ *
+ * A cell is forced if it has a single candidate (naked single) or holds the only candidate
+ * position of a digit in its row, column or block (hidden single). Solved cells are skipped.
+ * All units are evaluated on the same snapshot of the candidates.
+ *
+ * @param candidates Candidate masks by flat index; at least MAX_SIZE * MAX_SIZE entries, since
+ *                   vector loads may read past the last cell
+ * @param values Values by flat index (EMPTY for unsolved cells)
+ * @param out Receives the forced cells and digits
+ */
+template<typename G>
+void find_singles(const NumberSet *candidates, const Number *values, Singles &out) {
+    using namespace singles_detail;
+
+    constexpr int N = G::SIZE;
+    constexpr int W = Lanes::WIDTH;
+    constexpr int PAD = (N + W - 1) / W * W;
+    constexpr int BANDS = G::HAS_BLOCKS ? N / G::BLOCK : 1;
+
+    static_assert((N - 1) * N + PAD <= MAX_SIZE * MAX_SIZE, "Row loads must stay inside the cell arrays");
+
+    // lane c of every vector belongs to column c
+    alignas(32) std::array<bit_t, PAD> col_unique;
+    alignas(32) std::array<std::array<bit_t, PAD>, BANDS> band_once;
+    alignas(32) std::array<std::array<bit_t, PAD>, BANDS> band_twice;
+
+    for (int j = 0; j < PAD; j += W) {
+        Lanes once = Lanes::zero();
+        Lanes twice = Lanes::zero();
+        Lanes b_once = Lanes::zero();
+        Lanes b_twice = Lanes::zero();
+        for (int r = 0; r < N; r++) {
+            const Lanes x = Lanes::load(candidates + r * N + j);
+            twice = twice | (once & x);
+            once = once | x;
+            if constexpr (G::HAS_BLOCKS) {
+                b_twice = b_twice | (b_once & x);
+                b_once = b_once | x;
+                if (r % G::BLOCK == G::BLOCK - 1) {
+                    b_once.store(band_once[r / G::BLOCK].data() + j);
+                    b_twice.store(band_twice[r / G::BLOCK].data() + j);
+                    b_once = Lanes::zero();
+                    b_twice = Lanes::zero();
+                }
+            }
+        }
+
+        alignas(32) std::array<bit_t, W> o;
+        alignas(32) std::array<bit_t, W> t;
+        once.store(o.data());
+        twice.store(t.data());
+        for (int k = 0; k < W; k++)
+            col_unique[j + k] = static_cast<bit_t>(o[k] & ~t[k]);
+    }
+
+    // blocks: fold the columns of a band, spread the result back onto the block's lanes
+    alignas(32) std::array<std::array<bit_t, PAD>, BANDS> box_unique{};
+    if constexpr (G::HAS_BLOCKS) {
+        for (int band = 0; band < BANDS; band++) {
+            for (int c0 = 0; c0 < N; c0 += G::BLOCK) {
+                bit_t once = 0;
+                bit_t twice = 0;
+                for (int c = c0; c < c0 + G::BLOCK; c++) {
+                    twice |= (once & band_once[band][c]) | band_twice[band][c];
+                    once |= band_once[band][c];
+                }
+                for (int c = c0; c < c0 + G::BLOCK; c++)
+                    box_unique[band][c] = static_cast<bit_t>(once & ~twice);
+            }
+        }
+    }
+
+    out.conflict = false;
+    out.cells.clear();
+    for (int r = 0; r < N; r++) {
+        const NumberSet *row = candidates + r * N;
+
+        bit_t once = 0;
+        bit_t twice = 0;
+        for (int c = 0; c < N; c++) {
+            twice |= once & row[c].raw();
+            once |= row[c].raw();
+        }
+
+        // digits of every cell that are unique in one of its units
+        alignas(32) std::array<bit_t, PAD> unique;
+        for (int j = 0; j < PAD; j += W) {
+            const Lanes units = Lanes::splat(static_cast<bit_t>(once & ~twice))
+                                | Lanes::load(col_unique.data() + j)
+                                | Lanes::load(box_unique[G::HAS_BLOCKS ? r / G::BLOCK : 0].data() + j);
+            (Lanes::load(row + j) & units).store(unique.data() + j);
+        }
+
+        for (int c = 0; c < N; c++) {
+            const int idx = r * N + c;
+            if (values[idx] != EMPTY)
+                continue;
+
+            const bit_t cands = row[c].raw();
+            const bit_t forced = std::popcount(cands) == 1 ? cands : unique[c];
+            if (!forced)
+                continue;
+
+            out.conflict |= std::popcount(forced) > 1;
+            out.cells.set(idx);
+            out.digits[idx] = NumberSet(N, forced);
+        }
+    }
+}
+
+} // namespace sudoku
@@ -0,0 +1,120 @@
+/**
+ * @file trail.h
+ * @brief Undo trail used by the board to backtrack incrementally.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * Instead of copying the whole grid at every checkpoint, the trail records the previous
+ * state of a cell the first time it is modified after a checkpoint. Undoing a checkpoint
+ * only restores the cells that actually changed.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../cell.h"
+
+namespace sudoku {
+
+/**
+ * @class Trail
+ * @brief Stack of (cell, previous state) entries grouped by checkpoints.
+ *
+ * Every checkpoint gets a unique stamp. A cell remembers the stamp of the checkpoint at which
+ * it was last saved, so repeated modifications of the same cell within one checkpoint only
+ * produce a single entry. Modifications made while no checkpoint is open are not recorded.
+ */
+class Trail {
+public:
+    /**
+     * @brief Save the current state of a cell before it is modified.
+     * @param cell The cell that is about to change
+     */
+    void record(Cell &cell) {
+        if (marks_.empty() || cell.trail_stamp_ == stamp_)
+            return;
+        entries_.push_back({&cell, cell.candidates, cell.value, cell.trail_stamp_});
+        cell.trail_stamp_ = stamp_;
+    }
+
+    /**
+     * @brief Open a new checkpoint.
+     */
+    void push() {
+        marks_.push_back({entries_.size(), stamp_});
+        stamp_ = ++next_stamp_;
+    }
+
+    /**
+     * @brief Restore all cells modified since the last checkpoint and close it.
+     * @param on_restore Called with every restored cell after its state has been reverted
+     * @return True if successful, false if no checkpoint was open.
+     */
+    template<typename OnRestore>
+    bool pop(OnRestore &&on_restore) {
+        if (marks_.empty())
+            return false;
+
+        const Mark mark = marks_.back();
+        marks_.pop_back();
+
+        while (entries_.size() > mark.size) {
+            const Entry &entry = entries_.back();
+            entry.cell->value = entry.value;
+            entry.cell->candidates = entry.candidates;
+            entry.cell->trail_stamp_ = entry.stamp;
+            on_restore(*entry.cell);
+            entries_.pop_back();
+        }
+
+        stamp_ = mark.stamp;
+        return true;
+    }
+
+    /**
+     * @brief Calls `f` with every cell modified since the innermost checkpoint was opened.
+     */
+    template<typename F>
+    void for_each_recorded(F &&f) const {
+        const std::size_t begin = marks_.empty() ? entries_.size() : marks_.back().size;
+        for (std::size_t i = begin; i < entries_.size(); ++i)
+            f(*entries_[i].cell);
+    }
+
+    /**
+     * @brief Number of open checkpoints.
+     */
+    int depth() const { return static_cast<int>(marks_.size()); }
+
+    /**
+     * @brief Reserve space for the given number of entries and checkpoints.
+     */
+    void reserve(std::size_t entries, std::size_t marks) {
+        entries_.reserve(entries);
+        marks_.reserve(marks);
+    }
+
+private:
+    struct Entry {
+        Cell *cell; ///< Modified cell
+        NumberSet candidates; ///< Candidates before the modification
+        Number value; ///< Value before the modification
+        uint32_t stamp; ///< Stamp of the cell before the modification
+    };
+
+    struct Mark {
+        std::size_t size; ///< Number of entries when the checkpoint was opened
+        uint32_t stamp; ///< Stamp that was active before the checkpoint
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<Mark> marks_;
+    uint32_t stamp_ = 0; ///< Stamp of the innermost checkpoint (0 = none)
+    uint32_t next_stamp_ = 0; ///< Last stamp handed out
+};
+
+} // namespace sudoku
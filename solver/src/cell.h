@@ -3,8 +3,8 @@
  * @brief Defines a single cell in the Sudoku grid with value and candidate tracking.
  *
  * This file is part of the SudokuSolver project, developed for the Sudoku Website.
- * Each cell stores its position, current value, and candidate numbers using a
- * runtime-sized NumberSet.
+ * A cell is a handle onto one entry of the board's flat value and candidate arrays. It knows
+ * its position and routes every modification through the owning board.
  *
  * @date 2025-05-16
  * @author Finn Eggers
@@ -26,39 +26,40 @@ namespace sudoku {
  *
  * - If the cell is solved (value ≠ 0), candidates is a singleton containing only that value.
  * - If unsolved (value == 0), candidates holds all currently allowed numbers.
+ *
+ * `value` and `candidates` refer into the board's contiguous state arrays, so cells are created
+ * once by the board and never copied around.
  */
 class Cell {
 public:
     CellIdx pos; ///< Row/column position of the cell
-    Number value = 0; ///< 0 if unsolved, 1–N if solved
-    NumberSet candidates; ///< Active candidates (always consistent with value)
+    Number &value; ///< 0 if unsolved, 1–N if solved
+    NumberSet &candidates; ///< Active candidates (always consistent with value)
     int max_number = 9; ///< Board size (max value), e.g., 9 for 9x9
 
     /**
-     * @brief Construct an unsolved cell at (r,c) with board size N.
-     * @param r Row index
-     * @param c Column index
+     * @brief Construct a cell at (r,c) viewing the given board state.
+     * @param pos Row/column position
+     * @param value Slot of the cell in the board's value array
+     * @param candidates Slot of the cell in the board's candidate array
      * @param n Board size (default: 9)
      */
-    Cell(CellIdx pos, int n = 9) : pos(pos), value(0), candidates(NumberSet::full(n)), max_number(n) {}
+    Cell(CellIdx pos, Number &value, NumberSet &candidates, int n = 9) :
+        pos(pos), value(value), candidates(candidates), max_number(n) {}
+
+    Cell &operator=(const Cell &) = delete;
 
     /**
      * @brief Set the cell to a known value.
      * Updates candidates to be that value only.
      * @param v Solved value (must be in [1, max_number])
      */
-    void set_value(Number v) {
-        value = v;
-        candidates = NumberSet(max_number, v);
-    }
+    void set_value(Number v) { assign(v, NumberSet(max_number, v)); }
 
     /**
      * @brief Clears the cell (unsolved) and resets all candidates.
      */
-    void clear() {
-        value = 0;
-        candidates = NumberSet::full(max_number);
-    }
+    void clear() { assign(0, NumberSet::full(max_number)); }
 
     /**
      * @brief Removes a candidate number (if unsolved).
@@ -68,9 +69,9 @@ public:
     bool remove_candidate(Number number) {
         if (value != 0)
             return false;
-        NumberSet before = candidates;
-        candidates.remove(number);
-        return candidates != before;
+        NumberSet after = candidates;
+        after.remove(number);
+        return assign_candidates(after);
     }
 
     /**
@@ -81,9 +82,7 @@ public:
     bool remove_candidates(const NumberSet &remove_set) {
         if (value != 0)
             return false;
-        NumberSet before = candidates;
-        candidates = candidates & ~remove_set;
-        return candidates != before;
+        return assign_candidates(candidates - remove_set);
     }
 
     /**
@@ -94,9 +93,7 @@ public:
     bool only_allow_candidates(const NumberSet &allowed) {
         if (value != 0)
             return false;
-        NumberSet before = candidates;
-        candidates = candidates & allowed;
-        return candidates != before;
+        return assign_candidates(candidates & allowed);
     }
 
     /**
@@ -110,15 +107,32 @@ public:
      * @return True if value is non-zero
      */
     bool is_solved() const { return value != 0; }
-};
 
+private:
+    friend class Board;
+    friend class Trail;
 
-struct CellSnapshot {
-    Number value;
-    uint32_t candidate_bits;
-};
+    Board *board_ = nullptr; ///< Owning board, notified about every modification
+    uint32_t trail_stamp_ = 0; ///< Checkpoint at which this cell was last saved on the trail
 
-using Snapshot = std::vector<CellSnapshot>; // size = board_size_ * board_size_
+    /**
+     * @brief Replaces value and candidates, keeping the owning board's trail and cell index in sync.
+     * Defined in board.h, since it needs the complete Board; every translation unit that modifies
+     * cells must include board.h.
+     */
+    inline void assign(Number v, const NumberSet &next);
+
+    /**
+     * @brief Replaces the candidates if they differ from the current ones.
+     * @return True if candidates changed
+     */
+    bool assign_candidates(const NumberSet &next) {
+        if (next == candidates)
+            return false;
+        assign(value, next);
+        return true;
+    }
+};
 
 
 } // namespace sudoku
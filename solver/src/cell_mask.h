@@ -0,0 +1,168 @@
+/**
+ * @file cell_mask.h
+ * @brief Fixed-size bitset over all cells of a board.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * Cells are addressed by their flat index r * size + c. The mask is large enough for the
+ * biggest supported board (MAX_SIZE x MAX_SIZE) and never allocates.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+
+#include "defs.h"
+
+namespace sudoku {
+
+/**
+ * @class CellMask
+ * @brief Bitset with one bit per cell, iterated in ascending (row-major) order.
+ */
+class CellMask {
+public:
+    using word_t = uint64_t;
+
+    static constexpr int BITS = MAX_SIZE * MAX_SIZE;
+    static constexpr int WORDS = (BITS + 63) / 64;
+
+    // --- Modifiers ---
+
+    void set(int idx) {
+        assert_valid(idx);
+        words_[idx >> 6] |= word_t{1} << (idx & 63);
+    }
+
+    void reset(int idx) {
+        assert_valid(idx);
+        words_[idx >> 6] &= ~(word_t{1} << (idx & 63));
+    }
+
+    void clear() noexcept { words_.fill(0); }
+
+    // --- Queries ---
+
+    bool test(int idx) const {
+        assert_valid(idx);
+        return words_[idx >> 6] & (word_t{1} << (idx & 63));
+    }
+
+    bool any() const noexcept {
+        for (word_t w: words_)
+            if (w)
+                return true;
+        return false;
+    }
+
+    int count() const noexcept {
+        int total = 0;
+        for (word_t w: words_)
+            total += std::popcount(w);
+        return total;
+    }
+
+    /// Index of the lowest set bit, or -1 if the mask is empty.
+    int lowest() const noexcept {
+        for (int i = 0; i < WORDS; ++i)
+            if (words_[i])
+                return i * 64 + std::countr_zero(words_[i]);
+        return -1;
+    }
+
+    word_t word(int i) const { return words_[i]; }
+
+    // --- Iteration ---
+
+    class Iterator {
+    public:
+        using value_type = int;
+        using difference_type = int;
+        using iterator_category = std::input_iterator_tag;
+
+        Iterator(const CellMask *mask, int word) : mask_(mask), word_(word), bits_(0) {
+            if (word_ < WORDS)
+                bits_ = mask_->words_[word_];
+            skip_empty();
+        }
+
+        int operator*() const noexcept { return word_ * 64 + std::countr_zero(bits_); }
+
+        Iterator &operator++() noexcept {
+            bits_ &= bits_ - 1;
+            skip_empty();
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const noexcept {
+            return word_ != other.word_ || bits_ != other.bits_;
+        }
+
+    private:
+        const CellMask *mask_;
+        int word_;
+        word_t bits_;
+
+        void skip_empty() noexcept {
+            while (!bits_ && word_ < WORDS) {
+                if (++word_ < WORDS)
+                    bits_ = mask_->words_[word_];
+            }
+        }
+    };
+
+    Iterator begin() const noexcept { return Iterator(this, 0); }
+    Iterator end() const noexcept { return Iterator(this, WORDS); }
+
+    // --- Operators ---
+
+    CellMask operator|(const CellMask &other) const {
+        CellMask res = *this;
+        return res |= other;
+    }
+
+    CellMask &operator|=(const CellMask &other) {
+        for (int i = 0; i < WORDS; ++i)
+            words_[i] |= other.words_[i];
+        return *this;
+    }
+
+    CellMask operator&(const CellMask &other) const {
+        CellMask res = *this;
+        return res &= other;
+    }
+
+    CellMask &operator&=(const CellMask &other) {
+        for (int i = 0; i < WORDS; ++i)
+            words_[i] &= other.words_[i];
+        return *this;
+    }
+
+    /// Cells of this mask that are not set in the other one
+    CellMask operator-(const CellMask &other) const {
+        CellMask res = *this;
+        return res -= other;
+    }
+
+    CellMask &operator-=(const CellMask &other) {
+        for (int i = 0; i < WORDS; ++i)
+            words_[i] &= ~other.words_[i];
+        return *this;
+    }
+
+    bool operator==(const CellMask &other) const noexcept { return words_ == other.words_; }
+    bool operator!=(const CellMask &other) const noexcept { return !(*this == other); }
+
+private:
+    std::array<word_t, WORDS> words_{};
+
+    static void assert_valid(int idx) { assert(idx >= 0 && idx < BITS); }
+};
+
+} // namespace sudoku
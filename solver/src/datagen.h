@@ -14,10 +14,13 @@ namespace sudoku::datagen {
  * @param output_dir Directory to save the puzzle JSON
  * @param solutions_limit Maximum number of solutions to find
  * @param node_limit Node limit for uniqueness check
+ * @param seed Seed of all random decisions, the same seed generates the same puzzle
  * @param guesses_limit Maximum number of guesses allowed (default: 0, meaning no limit)
  */
-void generate_random_puzzle(const std::string &output_dir, int solutions_limit, int node_limit, int guesses_limit = 0) {
+void generate_random_puzzle(const std::string &output_dir, int solutions_limit, int node_limit, uint64_t seed,
+                            int guesses_limit = 0) {
     Board board{9};
+    board.set_seed(seed);
 
     // initialize all handlers needed
     board.add_handler(std::make_shared<RuleStandard>(&board));
@@ -35,7 +38,7 @@ void generate_random_puzzle(const std::string &output_dir, int solutions_limit,
         if (stats.solutions_found < 1)
             continue; // no solution found, try again
 
-        int idx = rand() % solutions.size();
+        int idx = std::uniform_int_distribution<int>(0, solutions.size() - 1)(board.rng());
         const auto &solution = solutions[idx];
 
         for (Row r = 0; r < board.size(); ++r) {
@@ -49,9 +52,7 @@ void generate_random_puzzle(const std::string &output_dir, int solutions_limit,
         break;
     }
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(filled_pos.begin(), filled_pos.end(), gen);
+    std::shuffle(filled_pos.begin(), filled_pos.end(), board.rng());
 
     for (const auto &pos: filled_pos) {
         Cell &cell = board.get_cell(pos);
@@ -59,13 +60,11 @@ void generate_random_puzzle(const std::string &output_dir, int solutions_limit,
         cell.clear();
 
         SolverStats test_stats;
-        auto test_solutions = board.solve(2, node_limit, &test_stats);
+        const auto test_result = board.check_unique(node_limit, &test_stats);
 
         bool keep_cell = false;
-        if (test_stats.solutions_found != 1)
-            keep_cell = true; // if we didn't get exactly one solution, keep the cell
-        else if (test_stats.interrupted_by_node_limit)
-            keep_cell = true; // if we hit the node limit, keep the cell
+        if (test_result.status != Uniqueness::Unique)
+            keep_cell = true; // if the solution is not unique (or the node limit was hit), keep the cell
         else if (test_stats.guesses_made > guesses_limit && guesses_limit > 0)
             keep_cell = true; // if we made too many guesses, keep the cell
 
@@ -24,16 +24,26 @@ std::string load_json_input(const std::string& input) {
 
 // ---- Core solve logic ----
 
-void solve(const std::string& json, int max_solutions, int max_nodes, bool smart_mode) {
+void solve(const std::string& json, int max_solutions, int max_nodes, bool smart_mode, int threads,
+           BranchHeuristic heuristic, int restart_unit, uint64_t seed) {
     std::cout << "STARTING\n";
     try {
         auto root = JSON::parse(json);
         Board board{9};
         board.from_json(root);
         board.set_smart_hints(smart_mode);
+        board.set_heuristic(heuristic);
+        board.set_seed(seed);
+
+        // the multi-threaded search does not restart, tell the caller instead of dropping the option
+        if (restart_unit > 0 && threads != 1)
+            std::cout << "[WARNING] --restarts is ignored when solving with more than one thread\n";
+        else
+            board.set_restart_unit(restart_unit);
 
         SolverStats stats;
-        auto solutions = board.solve(max_solutions, max_nodes, &stats);
+        auto solutions = threads == 1 ? board.solve(max_solutions, max_nodes, &stats)
+                                      : board.solve_parallel(max_solutions, max_nodes, threads, &stats);
 
         for (auto& sol : solutions)
             std::cout << "[SOLUTION]" << sol << "\n";
@@ -41,7 +51,11 @@ void solve(const std::string& json, int max_solutions, int max_nodes, bool smart
         std::cout << "[INFO]solutions_found=" << stats.solutions_found << "\n";
         std::cout << "[INFO]nodes_explored=" << stats.nodes_explored << "\n";
         std::cout << "[INFO]guesses_made=" << stats.guesses_made << "\n";
+        std::cout << "[INFO]restarts=" << stats.restarts << "\n";
+        std::cout << "[INFO]handler_calls=" << stats.handler_calls << "\n";
         std::cout << "[INFO]time_taken_ms=" << std::fixed << std::setprecision(3) << stats.time_taken_ms << "\n";
+        if (alloc_counter::enabled)
+            std::cout << "[INFO]allocations=" << stats.allocations << "\n";
         std::cout << "[INFO]interrupted_by_node_limit=" << (stats.interrupted_by_node_limit ? "true" : "false") << "\n";
         std::cout << "[INFO]interrupted_by_solution_limit=" << (stats.interrupted_by_solution_limit ? "true" : "false") << "\n";
     } catch (const std::exception& e) {
@@ -50,13 +64,16 @@ void solve(const std::string& json, int max_solutions, int max_nodes, bool smart
     std::cout << "[DONE]\n";
 }
 
-void solve_complete(const std::string& json, int max_nodes, bool smart_mode) {
+void solve_complete(const std::string& json, int max_nodes, bool smart_mode, int threads, BranchHeuristic heuristic,
+                    uint64_t seed) {
     std::cout << "STARTING\n";
     try {
         auto root = JSON::parse(json);
         Board board{9};
         board.from_json(root);
         board.set_smart_hints(smart_mode);
+        board.set_heuristic(heuristic);
+        board.set_seed(seed);
 
         SolverStats stats;
         float last_progress = -1.0f;
@@ -71,11 +88,73 @@ void solve_complete(const std::string& json, int max_nodes, bool smart_mode) {
                              },
                              [&](Solution& sol) {
                                  std::cout << "[SOLUTION]" << sol << "\n";
-                             });
+                             },
+                             threads);
 
         std::cout << "[INFO]solutions_found=" << stats.solutions_found << "\n";
         std::cout << "[INFO]nodes_explored=" << stats.nodes_explored << "\n";
+        std::cout << "[INFO]handler_calls=" << stats.handler_calls << "\n";
+        std::cout << "[INFO]time_taken_ms=" << std::fixed << std::setprecision(3) << stats.time_taken_ms << "\n";
+        if (alloc_counter::enabled)
+            std::cout << "[INFO]allocations=" << stats.allocations << "\n";
+        std::cout << "[INFO]interrupted_by_node_limit=" << (stats.interrupted_by_node_limit ? "true" : "false") << "\n";
+        std::cout << "[INFO]interrupted_by_solution_limit=" << (stats.interrupted_by_solution_limit ? "true" : "false") << "\n";
+    } catch (const std::exception& e) {
+        std::cout << "[INFO]error=" << e.what() << "\n";
+    }
+    std::cout << "[DONE]\n";
+}
+
+void check_unique(const std::string& json, int max_nodes, bool smart_mode, BranchHeuristic heuristic, uint64_t seed) {
+    std::cout << "STARTING\n";
+    try {
+        auto root = JSON::parse(json);
+        Board board{9};
+        board.from_json(root);
+        board.set_smart_hints(smart_mode);
+        board.set_heuristic(heuristic);
+        board.set_seed(seed);
+
+        SolverStats stats;
+        const auto result = board.check_unique(max_nodes, &stats);
+
+        if (result.solution)
+            std::cout << "[SOLUTION]" << *result.solution << "\n";
+
+        std::cout << "[INFO]uniqueness=" << uniqueness_name(result.status) << "\n";
+        std::cout << "[INFO]nodes_explored=" << stats.nodes_explored << "\n";
+        std::cout << "[INFO]guesses_made=" << stats.guesses_made << "\n";
+        std::cout << "[INFO]handler_calls=" << stats.handler_calls << "\n";
+        std::cout << "[INFO]time_taken_ms=" << std::fixed << std::setprecision(3) << stats.time_taken_ms << "\n";
+        if (alloc_counter::enabled)
+            std::cout << "[INFO]allocations=" << stats.allocations << "\n";
+    } catch (const std::exception& e) {
+        std::cout << "[INFO]error=" << e.what() << "\n";
+    }
+    std::cout << "[DONE]\n";
+}
+
+void count_solutions(const std::string& json, uint64_t limit, int max_nodes, bool smart_mode, BranchHeuristic heuristic,
+                     uint64_t seed) {
+    std::cout << "STARTING\n";
+    try {
+        auto root = JSON::parse(json);
+        Board board{9};
+        board.from_json(root);
+        board.set_smart_hints(smart_mode);
+        board.set_heuristic(heuristic);
+        board.set_seed(seed);
+
+        SolverStats stats;
+        const uint64_t count = board.count_solutions(limit, max_nodes, &stats);
+
+        std::cout << "[INFO]solution_count=" << count << "\n";
+        std::cout << "[INFO]nodes_explored=" << stats.nodes_explored << "\n";
+        std::cout << "[INFO]guesses_made=" << stats.guesses_made << "\n";
+        std::cout << "[INFO]handler_calls=" << stats.handler_calls << "\n";
         std::cout << "[INFO]time_taken_ms=" << std::fixed << std::setprecision(3) << stats.time_taken_ms << "\n";
+        if (alloc_counter::enabled)
+            std::cout << "[INFO]allocations=" << stats.allocations << "\n";
         std::cout << "[INFO]interrupted_by_node_limit=" << (stats.interrupted_by_node_limit ? "true" : "false") << "\n";
         std::cout << "[INFO]interrupted_by_solution_limit=" << (stats.interrupted_by_solution_limit ? "true" : "false") << "\n";
     } catch (const std::exception& e) {
@@ -98,44 +177,103 @@ int run_internal(const std::string& commandline) {
     auto& opt_node_lim  = parser.add_option("node_limit", "Max number of nodes");
     auto& opt_smart     = parser.add_option("smart", "Enable smart solving");
     auto& opt_out       = parser.add_option("out", "Output path");
+    auto& opt_threads   = parser.add_option("threads", "Number of solver threads (0 = all cores)");
+    auto& opt_heuristic = parser.add_option("heuristic", "Branching heuristic: impact (default) or wdeg");
+    auto& opt_restarts  = parser.add_option("restarts", "Nodes of the shortest run between search restarts (0 = off, single thread only)");
+    auto& opt_seed      = parser.add_option("seed", "Seed of the random decisions (same seed, same search)");
 
     auto& solve_cmd = parser.add_command("solve", [&](ArgParser& p) {
         std::string json = load_json_input(p.require<std::string>("json"));
         solve(json,
               p.require<int>("sol_limit"),
               p.require<int>("node_limit"),
-              p.get<bool>("smart", false));
+              p.get<bool>("smart", false),
+              p.get<int>("threads", 1),
+              parse_branch_heuristic(p.get<std::string>("heuristic", "impact")),
+              p.get<int>("restarts", 0),
+              p.get<uint64_t>("seed", DEFAULT_SEED));
     });
     parser.add_required(solve_cmd, opt_json);
     parser.add_required(solve_cmd, opt_sol_limit);
     parser.add_required(solve_cmd, opt_node_lim);
     parser.add_optional(solve_cmd, opt_smart);
+    parser.add_optional(solve_cmd, opt_threads);
+    parser.add_optional(solve_cmd, opt_heuristic);
+    parser.add_optional(solve_cmd, opt_restarts);
+    parser.add_optional(solve_cmd, opt_seed);
 
     auto& complete_cmd = parser.add_command("complete", [&](ArgParser& p) {
         std::string json = load_json_input(p.require<std::string>("json"));
         solve_complete(json,
                        p.require<int>("node_limit"),
-                       p.get<bool>("smart", false));
+                       p.get<bool>("smart", false),
+                       p.get<int>("threads", 1),
+                       parse_branch_heuristic(p.get<std::string>("heuristic", "impact")),
+                       p.get<uint64_t>("seed", DEFAULT_SEED));
     });
     parser.add_required(complete_cmd, opt_json);
     parser.add_required(complete_cmd, opt_node_lim);
     parser.add_optional(complete_cmd, opt_smart);
+    parser.add_optional(complete_cmd, opt_threads);
+    parser.add_optional(complete_cmd, opt_heuristic);
+    parser.add_optional(complete_cmd, opt_seed);
 
-    auto& bench_cmd = parser.add_command("bench", [&](ArgParser& p) {
+    auto& unique_cmd = parser.add_command("unique", [&](ArgParser& p) {
         std::string json = load_json_input(p.require<std::string>("json"));
-        bench::bench(json, 17, 128000, p.get<bool>("smart", false));
+        check_unique(json,
+                     p.require<int>("node_limit"),
+                     p.get<bool>("smart", false),
+                     parse_branch_heuristic(p.get<std::string>("heuristic", "impact")),
+                     p.get<uint64_t>("seed", DEFAULT_SEED));
+    });
+    parser.add_required(unique_cmd, opt_json);
+    parser.add_required(unique_cmd, opt_node_lim);
+    parser.add_optional(unique_cmd, opt_smart);
+    parser.add_optional(unique_cmd, opt_heuristic);
+    parser.add_optional(unique_cmd, opt_seed);
+
+    auto& count_cmd = parser.add_command("count", [&](ArgParser& p) {
+        std::string json = load_json_input(p.require<std::string>("json"));
+        count_solutions(json,
+                        p.require<uint64_t>("sol_limit"),
+                        p.require<int>("node_limit"),
+                        p.get<bool>("smart", false),
+                        parse_branch_heuristic(p.get<std::string>("heuristic", "impact")),
+                        p.get<uint64_t>("seed", DEFAULT_SEED));
+    });
+    parser.add_required(count_cmd, opt_json);
+    parser.add_required(count_cmd, opt_sol_limit);
+    parser.add_required(count_cmd, opt_node_lim);
+    parser.add_optional(count_cmd, opt_smart);
+    parser.add_optional(count_cmd, opt_heuristic);
+    parser.add_optional(count_cmd, opt_seed);
+
+    auto& bench_cmd = parser.add_command("bench", [&](ArgParser& p) {
+        // bench reads the puzzle files itself, it takes a path rather than JSON text
+        std::string path = p.require<std::string>("json");
+        bench::bench(path, 17, 128000, p.get<bool>("smart", false),
+                     parse_branch_heuristic(p.get<std::string>("heuristic", "impact")),
+                     p.get<int>("restarts", 0),
+                     p.get<uint64_t>("seed", DEFAULT_SEED));
     });
     parser.add_required(bench_cmd, opt_json);
     parser.add_optional(bench_cmd, opt_smart);
+    parser.add_optional(bench_cmd, opt_heuristic);
+    parser.add_optional(bench_cmd, opt_restarts);
+    parser.add_optional(bench_cmd, opt_seed);
 
     auto& datagen_cmd = parser.add_command("datagen", [&](ArgParser& p) {
         std::string out = p.require<std::string>("out");
+        // without a seed every run generates new puzzles, the seed is printed to reproduce them
+        const uint64_t seed = p.get<uint64_t>("seed", random_seed());
+        std::cout << "[INFO]seed=" << seed << "\n";
         for (int i = 0; i < 3; ++i) {
             std::cout << "Generating puzzle " << (i + 1) << "/3...\n";
-            datagen::generate_random_puzzle(out, 17, 128000);
+            datagen::generate_random_puzzle(out, 17, 128000, derive_seed(seed, i));
         }
     });
     parser.add_required(datagen_cmd, opt_out);
+    parser.add_optional(datagen_cmd, opt_seed);
 
     try {
         parser.parse(commandline);
@@ -1,10 +1,11 @@
 /**
  * @file NumberSet.h
- * @brief Runtime-sized bitset for representing allowed Sudoku numbers.
+ * @brief Compact bitset for representing allowed Sudoku numbers.
  *
  * This file is part of the SudokuSolver project, developed for the Sudoku Website.
- * It defines a compact bitmask-based representation for numbers in the range [1, N],
- * where N is a runtime parameter (typically 9).
+ * It defines a 16-bit bitmask-based representation for numbers in the range [1, N].
+ * The set only stores the bits; N is supplied by the context whenever a set is created
+ * relative to the board size (full sets, ranges, parity masks).
  *
  * @date 2025-05-16
  * @author Finn Eggers
@@ -13,6 +14,7 @@
 #ifndef NUMBERSET_H
 #define NUMBERSET_H
 
+#include <algorithm>
 #include <bit>
 #include <cassert>
 #include <cstdint>
@@ -26,115 +28,117 @@ namespace sudoku {
 
 /**
  * @class NumberSet
- * @brief Represents a set of numbers from 1 to N using a 64-bit bitmask.
+ * @brief Represents a set of numbers from 1 to N using a 16-bit bitmask.
  *
- * N is provided at runtime, and all operations enforce the valid range [1, N].
+ * Number n is stored in bit n - 1. All operations only combine bits, so sets created for the
+ * same board can be mixed freely without carrying the board size around.
  */
 class NumberSet {
 public:
-    using bit_t = uint32_t;
+    using bit_t = uint16_t;
+
+    static_assert(MAX_SIZE <= 16, "NumberSet holds at most 16 numbers");
 
     /// Constructors
 
+    /**
+     * @brief Construct an empty NumberSet.
+     */
+    constexpr NumberSet() = default;
+
     /**
      * @brief Construct an empty NumberSet for a given size N.
      * @param max_number The maximum number allowed (must be in [1, MAX_SIZE])
      */
-    explicit NumberSet(int max_number) : max_number_(max_number), bits_(0) {
-        assert(max_number_ >= 1 && max_number_ <= MAX_SIZE);
-        mask_ = compute_mask(max_number_);
-    }
+    explicit NumberSet(int max_number) { assert(max_number >= 1 && max_number <= MAX_SIZE); }
 
     /**
      * @brief Construct a singleton NumberSet with a single number.
      * @param max_number Upper limit of the range.
      * @param num Number to add initially.
      */
-    NumberSet(int max_number, Number num) : max_number_(max_number), bits_(0) {
-        assert(max_number_ >= 1 && max_number_ <= MAX_SIZE);
-        mask_ = compute_mask(max_number_);
-        add(num);
+    NumberSet(int max_number, Number num) : bits_(bit(num)) {
+        assert(max_number >= 1 && max_number <= MAX_SIZE);
+        assert(num >= 0 && num <= max_number);
     }
 
     /**
      * @brief Construct from bitmask (used for internal operations).
-     * @param max_number Maximum number.
-     * @param bits Bitmask representing values.
+     * @param max_number Maximum number, bits above it are dropped.
+     * @param bits Bitmask representing values (bit n - 1 = number n).
      */
-    NumberSet(int max_number, bit_t bits) : max_number_(max_number), bits_(bits) {
-        assert(max_number_ >= 1 && max_number_ <= MAX_SIZE);
-        mask_ = compute_mask(max_number_);
-        bits_ &= mask_;
+    NumberSet(int max_number, bit_t bits) : bits_(bits & mask(max_number)) {
+        assert(max_number >= 1 && max_number <= MAX_SIZE);
     }
 
+    /// Returns the bit representing a number (0 for EMPTY)
+    static constexpr bit_t bit(Number num) { return static_cast<bit_t>((1u << num) >> 1); }
+
+    /// Returns the bits of all numbers 1 to max_number
+    static constexpr bit_t mask(int max_number) { return static_cast<bit_t>((1u << max_number) - 1); }
+
     /// Returns a full NumberSet (1 to max_number)
-    static NumberSet full(int max_number) { return {max_number, compute_mask(max_number)}; }
+    static NumberSet full(int max_number) { return {max_number, mask(max_number)}; }
 
     /// Returns an empty NumberSet
-    static NumberSet empty(int max_number) { return {max_number, Number(0)}; }
+    static NumberSet empty(int max_number) { return NumberSet(max_number); }
 
     static NumberSet greaterThan(int max_number, Number num) {
         assert(num >= 0 && num <= max_number);
-        return {max_number, compute_mask(max_number) & ~((bit_t{1} << (num + 1)) - 1)};
+        return {max_number, static_cast<bit_t>(mask(max_number) & ~mask(num))};
     }
 
     static NumberSet greaterEqThan(int max_number, Number num) {
         assert(num >= 0 && num <= max_number);
-        return {max_number, compute_mask(max_number) & ~((bit_t{1} << num) - 1)};
+        return {max_number, static_cast<bit_t>(mask(max_number) & ~mask(std::max(num - 1, 0)))};
     }
 
     static NumberSet lessThan(int max_number, Number num) {
         assert(num >= 0 && num <= max_number);
-        return {max_number, (bit_t{1} << num) - 1};
+        return {max_number, mask(std::max(num - 1, 0))};
     }
 
     static NumberSet lessEqThan(int max_number, Number num) {
         assert(num >= 0 && num <= max_number);
-        return {max_number, (bit_t{1} << (num + 1)) - 1};
+        return {max_number, mask(num)};
     }
 
     static NumberSet odd(int max_number) {
         assert(max_number >= 1 && max_number <= MAX_SIZE);
-        return {max_number, (bit_t) compute_mask(max_number) & (bit_t) 0xAAAAAAAAAAAAAAAA};
+        return {max_number, static_cast<bit_t>(0x5555)};
     }
 
     static NumberSet even(int max_number) {
         assert(max_number >= 1 && max_number <= MAX_SIZE);
-        return {max_number, (bit_t) compute_mask(max_number) & (bit_t) 0x5555555555555555};
+        return {max_number, static_cast<bit_t>(0xAAAA)};
     }
 
     // --- Modifiers ---
 
     void add(Number num) {
         assert_valid(num);
-        bits_ |= (bit_t{1} << num);
+        bits_ |= bit(num);
     }
 
-    void remove(Number num) {
-        // assert_valid(num);
-        bits_ &= ~(bit_t{1} << num);
-    }
+    void remove(Number num) { bits_ &= ~bit(num); }
 
     void clear() noexcept { bits_ = 0; }
-    void set_all() noexcept { bits_ = mask_; }
 
     // --- Queries ---
 
     bool test(Number num) const {
         assert_valid(num);
-        return bits_ & (bit_t{1} << num);
+        return bits_ & bit(num);
     }
 
     int count() const noexcept { return std::popcount(bits_); }
 
-    Number lowest() const noexcept { return bits_ ? static_cast<Number>(std::countr_zero(bits_)) : 0; }
+    Number lowest() const noexcept { return bits_ ? static_cast<Number>(std::countr_zero(bits_) + 1) : 0; }
 
-    Number highest() const noexcept { return bits_ ? static_cast<Number>(31 - std::countl_zero(bits_)) : 0; }
+    Number highest() const noexcept { return static_cast<Number>(16 - std::countl_zero(bits_)); }
 
     bit_t raw() const noexcept { return bits_; }
 
-    int max_number() const noexcept { return max_number_; }
-
     // --- Iteration ---
 
     class Iterator {
@@ -143,77 +147,58 @@ public:
         using difference_type = int;
         using iterator_category = std::input_iterator_tag;
 
-        Iterator(bit_t bits, int max_number, Number start) :
-            bits_(bits), max_(max_number), cur_(advance(bits, start, max_number)) {}
+        explicit Iterator(bit_t bits) : bits_(bits) {}
 
-        Number operator*() const noexcept { return cur_; }
+        Number operator*() const noexcept { return static_cast<Number>(std::countr_zero(bits_) + 1); }
 
         Iterator &operator++() noexcept {
-            cur_ = advance(bits_, cur_ + 1, max_);
+            bits_ &= bits_ - 1;
             return *this;
         }
 
-        bool operator!=(const Iterator &other) const noexcept { return cur_ != other.cur_; }
+        bool operator!=(const Iterator &other) const noexcept { return bits_ != other.bits_; }
 
     private:
         bit_t bits_;
-        int max_;
-        Number cur_;
-
-        static Number advance(bit_t bits, Number start, int max) {
-            for (Number i = start; i <= max; ++i) {
-                if (bits & (bit_t{1} << i))
-                    return i;
-            }
-            return max + 1;
-        }
     };
 
-    Iterator begin() const noexcept { return Iterator(bits_, max_number_, 1); }
-    Iterator end() const noexcept { return Iterator(bits_, max_number_, max_number_ + 1); }
+    Iterator begin() const noexcept { return Iterator(bits_); }
+    Iterator end() const noexcept { return Iterator(0); }
 
     // --- Operators ---
 
-    NumberSet operator|(const NumberSet &other) const {
-        assert(max_number_ == other.max_number_);
-        return NumberSet(max_number_, bits_ | other.bits_);
-    }
+    NumberSet operator|(const NumberSet &other) const { return from_bits(bits_ | other.bits_); }
 
     NumberSet operator|=(const NumberSet &other) {
-        assert(max_number_ == other.max_number_);
-        this->bits_ |= other.bits_;
+        bits_ |= other.bits_;
         return *this;
     }
 
-    NumberSet operator&(const NumberSet &other) const {
-        assert(max_number_ == other.max_number_);
-        return NumberSet(max_number_, bits_ & other.bits_);
-    }
+    NumberSet operator&(const NumberSet &other) const { return from_bits(bits_ & other.bits_); }
 
     NumberSet operator&=(const NumberSet &other) {
-        assert(max_number_ == other.max_number_);
-        this->bits_ &= other.bits_;
+        bits_ &= other.bits_;
         return *this;
     }
 
-    NumberSet operator^(const NumberSet &other) const {
-        assert(max_number_ == other.max_number_);
-        return NumberSet(max_number_, bits_ ^ other.bits_);
-    }
+    NumberSet operator^(const NumberSet &other) const { return from_bits(bits_ ^ other.bits_); }
 
     NumberSet operator^=(const NumberSet &other) {
-        assert(max_number_ == other.max_number_);
-        this->bits_ ^= other.bits_;
+        bits_ ^= other.bits_;
         return *this;
     }
 
-    bool operator==(const NumberSet &other) const noexcept {
-        return max_number_ == other.max_number_ && bits_ == other.bits_;
+    /// Set difference: numbers in this set but not in the other one
+    NumberSet operator-(const NumberSet &other) const { return from_bits(bits_ & ~other.bits_); }
+
+    NumberSet operator-=(const NumberSet &other) {
+        bits_ &= ~other.bits_;
+        return *this;
     }
 
-    bool operator!=(const NumberSet &other) const noexcept { return !(*this == other); }
+    bool operator==(const NumberSet &other) const noexcept { return bits_ == other.bits_; }
 
-    friend NumberSet operator~(const NumberSet &a) noexcept { return NumberSet(a.max_number_, ~a.bits_ & a.mask_); }
+    bool operator!=(const NumberSet &other) const noexcept { return !(*this == other); }
 
     friend std::ostream &operator<<(std::ostream &os, const NumberSet &s) {
         for (auto v: s)
@@ -222,13 +207,15 @@ public:
     }
 
 private:
-    int max_number_;
     bit_t bits_ = 0;
-    bit_t mask_ = 0;
 
-    static constexpr bit_t compute_mask(int n) { return ((bit_t{1} << (n + 1)) - 1) & ~bit_t{1}; }
+    static NumberSet from_bits(unsigned bits) {
+        NumberSet res;
+        res.bits_ = static_cast<bit_t>(bits);
+        return res;
+    }
 
-    void assert_valid(Number num) const { assert(num >= 0 && num <= max_number_); }
+    static void assert_valid(Number num) { assert(num >= 0 && num <= MAX_SIZE); }
 };
 
 } // namespace sudoku
@@ -0,0 +1,129 @@
+/**
+ * @file cell_lookup.h
+ * @brief Per-cell index of the sub-constraints (cages, paths, edges, ...) of a rule.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * Rules with many sub-constraints build a lookup when they are loaded, so that reacting to a
+ * changed cell only visits the sub-constraints touching it instead of scanning all regions.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "CellIdx.h"
+#include "region.h"
+
+namespace sudoku {
+
+/**
+ * @class CellLookup
+ * @brief Maps every cell to the indices of the sub-constraints that contain it.
+ *
+ * Items are stored in the order they were added, so iterating the items of a cell visits the
+ * sub-constraints in the same order as iterating the rule's own list.
+ */
+class CellLookup {
+public:
+    /**
+     * @brief Removes all items and sizes the lookup for a board of the given size.
+     */
+    void reset(int board_size) {
+        board_size_ = board_size;
+        items_.assign(board_size * board_size, {});
+        registrations_ = 0;
+    }
+
+    /**
+     * @brief Registers an item at a cell. Adding the same item twice in a row is ignored.
+     */
+    void add(const CellIdx &pos, int item) {
+        std::vector<int> &items = items_[flat(pos)];
+        if (items.empty() || items.back() != item) {
+            items.push_back(item);
+            ++registrations_;
+        }
+    }
+
+    /**
+     * @brief Registers an item at every cell of a region.
+     */
+    void add(const Region<CellIdx> &region, int item) {
+        for (const auto &pos: region)
+            add(pos, item);
+    }
+
+    /**
+     * @brief Rebuilds the lookup so that item i refers to regions[i].
+     */
+    void build(int board_size, const std::vector<Region<CellIdx>> &regions) {
+        reset(board_size);
+        for (int i = 0; i < static_cast<int>(regions.size()); ++i)
+            add(regions[i], i);
+    }
+
+    /**
+     * @brief Items registered at a cell, in insertion order.
+     */
+    const std::vector<int> &operator[](const CellIdx &pos) const { return items_[flat(pos)]; }
+
+    /**
+     * @brief Returns true if the given item is registered at the cell.
+     */
+    bool has(const CellIdx &pos, int item) const {
+        for (int i: items_[flat(pos)])
+            if (i == item)
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Items registered at any of the given cells, each listed once in ascending order.
+     *
+     * The returned list is reused by the next call. Its capacity covers every registration, so
+     * it never grows during a search.
+     */
+    const std::vector<int> &touched(const std::vector<CellIdx> &cells) const {
+        touched_.clear();
+        if (items_.empty())
+            return touched_;
+        touched_.reserve(registrations_);
+
+        for (const auto &pos: cells)
+            for (int item: items_[flat(pos)])
+                touched_.push_back(item);
+
+        std::sort(touched_.begin(), touched_.end());
+        touched_.erase(std::unique(touched_.begin(), touched_.end()), touched_.end());
+        return touched_;
+    }
+
+    /**
+     * @brief All cells with at least one item, in row-major order.
+     */
+    Region<CellIdx> cells() const {
+        Region<CellIdx> res;
+        for (int i = 0; i < static_cast<int>(items_.size()); ++i)
+            if (!items_[i].empty())
+                res.add(CellIdx(i / board_size_, i % board_size_));
+        return res;
+    }
+
+private:
+    int board_size_ = 0;
+    std::vector<std::vector<int>> items_; ///< Items per flat cell index (r * size + c)
+    int registrations_ = 0; ///< Number of (cell, item) pairs, the largest possible touched() list
+    mutable std::vector<int> touched_; ///< Result buffer of touched()
+
+    int flat(const CellIdx &pos) const {
+        assert(pos.r >= 0 && pos.r < board_size_ && pos.c >= 0 && pos.c < board_size_);
+        return pos.r * board_size_ + pos.c;
+    }
+};
+
+} // namespace sudoku
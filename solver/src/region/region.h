@@ -4,7 +4,9 @@
  *
  * This file is part of the SudokuSolver project, developed for the Sudoku Website.
  * The Region class wraps collections of index objects (e.g. CellIdx, EdgeIdx) and
- * provides utilities for set operations, JSON parsing, and cell expansion.
+ * provides utilities for set operations, JSON parsing, and cell expansion. Cell regions keep a
+ * bitmask of their cells next to the ordered list, so membership tests and set operations do not
+ * search the list.
  *
  * @date 2025-05-16
  * @author Finn Eggers
@@ -16,7 +18,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "../cell_mask.h"
 #include "../defs.h"
 #include "../json/json.h"
 #include "CellIdx.h"
@@ -32,7 +36,9 @@ namespace sudoku {
  * @class Region
  * @brief Represents a typed collection of index objects (CellIdx, EdgeIdx, etc.).
  *
- * Provides set-like behavior, JSON parsing, and conversion to covered cells.
+ * Provides set-like behavior, JSON parsing, and conversion to covered cells. Items keep the
+ * order in which they were added. For CellIdx regions a CellMask mirrors the items, making has()
+ * and add() O(1) and the set operations linear; other index types search the list.
  *
  * @tparam IdxT Type of index (e.g., CellIdx, EdgeIdx, etc.).
  */
@@ -41,6 +47,9 @@ class Region {
 public:
     using value_type = IdxT;
 
+    /// True if the region mirrors its items in a CellMask
+    static constexpr bool MASKED = std::is_same_v<IdxT, CellIdx>;
+
     /**
      * @brief Default constructor.
      */
@@ -55,15 +64,23 @@ public:
     /**
      * @brief Clears the region.
      */
-    void clear() { items_.clear(); }
+    void clear() {
+        items_.clear();
+        if constexpr (MASKED)
+            mask_.clear();
+    }
 
     /**
      * @brief Adds an index to the region if not already present.
      * @param idx The index to add.
      */
     void add(const IdxT &idx) {
-        if (!has(idx))
-            items_.push_back(idx);
+        if (has(idx))
+            return;
+        items_.push_back(idx);
+        if constexpr (MASKED)
+            if (maskable(idx))
+                mask_.set(mask_bit(idx));
     }
 
     /**
@@ -71,7 +88,12 @@ public:
      * @param idx The index to search for.
      * @return True if present.
      */
-    bool has(const IdxT &idx) const { return find_index(idx) != -1; }
+    bool has(const IdxT &idx) const {
+        if constexpr (MASKED)
+            if (maskable(idx))
+                return mask_.test(mask_bit(idx));
+        return find_index(idx) != -1;
+    }
 
     /**
      * @brief Finds the index of a given element in the region.
@@ -79,6 +101,9 @@ public:
      * @return Index of the element, or -1 if not found.
      */
     int find_index(const IdxT &idx) const {
+        if constexpr (MASKED)
+            if (maskable(idx) && !mask_.test(mask_bit(idx)))
+                return -1;
         auto it = std::find(items_.begin(), items_.end(), idx);
         if (it != items_.end())
             return static_cast<int>(std::distance(items_.begin(), it));
@@ -93,6 +118,7 @@ public:
      */
     Region operator|(const Region &other) const {
         Region result = *this;
+        result.items_.reserve(items_.size() + other.items_.size());
         for (const auto &idx: other.items_) {
             result.add(idx);
         }
@@ -105,6 +131,9 @@ public:
      * @return Resulting intersection region.
      */
     Region operator&(const Region &other) const {
+        if constexpr (MASKED)
+            return filtered(mask_ & other.mask_, other, true);
+
         Region result;
         for (const auto &idx: items_) {
             if (other.has(idx))
@@ -119,6 +148,9 @@ public:
      * @return Resulting difference region.
      */
     Region operator-(const Region &other) const {
+        if constexpr (MASKED)
+            return filtered(mask_ - other.mask_, other, false);
+
         Region result;
         for (const auto &idx: items_) {
             if (!other.has(idx))
@@ -133,10 +165,15 @@ public:
      * @return Resulting region without the specified index.
      */
     Region operator-(const IdxT &idx) const {
+        if constexpr (MASKED)
+            if (!has(idx))
+                return *this;
+
         Region result;
+        result.items_.reserve(items_.size());
         for (const auto &item: items_) {
             if (!(item == idx))
-                result.items_.push_back(item);
+                result.add_new(item);
         }
         return result;
     }
@@ -187,6 +224,8 @@ public:
 
     /**
      * @brief Returns a mutable iterator to the first element in the region.
+     *
+     * Meant for reordering the items; replacing an item would leave the cell mask stale.
      * @return Mutable iterator to the beginning.
      */
     typename std::vector<IdxT>::iterator begin() { return items_.begin(); }
@@ -203,6 +242,7 @@ public:
      */
     const std::vector<IdxT> &items() const { return items_; }
 
+    /// Mutable items, for reordering only (see begin())
     std::vector<IdxT> &items() { return items_; }
 
     /**
@@ -298,7 +338,38 @@ public:
     }
 
 private:
+    struct NoMask {};
+
     std::vector<IdxT> items_;
+    [[no_unique_address]] std::conditional_t<MASKED, CellMask, NoMask> mask_; ///< Cells of items_ (CellIdx only)
+
+    /// Cells outside the largest board are not mirrored in the mask and are searched in the list
+    static bool maskable(const CellIdx &idx) { return idx.r >= 0 && idx.r < MAX_SIZE && idx.c >= 0 && idx.c < MAX_SIZE; }
+    static int mask_bit(const CellIdx &idx) { return idx.r * MAX_SIZE + idx.c; }
+
+    /// Appends an item known not to be in the region yet
+    void add_new(const IdxT &idx) {
+        items_.push_back(idx);
+        if constexpr (MASKED)
+            if (maskable(idx))
+                mask_.set(mask_bit(idx));
+    }
+
+    /**
+     * @brief Items of this region selected by a precomputed mask, in this region's order.
+     *
+     * Items outside the mask range fall back to a membership test in `other`.
+     */
+    Region filtered(const CellMask &selected, const Region &other, bool keep_shared) const {
+        Region result;
+        result.mask_ = selected;
+        for (const auto &idx: items_) {
+            const bool keep = maskable(idx) ? selected.test(mask_bit(idx)) : other.has(idx) == keep_shared;
+            if (keep)
+                result.items_.push_back(idx);
+        }
+        return result;
+    }
 
     // Dispatch for different attached_cells() signatures
     static std::vector<CellIdx> call_attached_cells(const CellIdx &idx, int) { return idx.attached_cells(); }
@@ -3,3 +3,14 @@
 //
 
 #include "_rule_handler.h"
+#include "../board/board.h"
+
+namespace sudoku {
+
+Region<CellIdx> RuleHandler::watched_cells() const { return Region<CellIdx>::all(board_->size()); }
+
+Region<CellIdx> RuleHandler::subscribed_cells() const { return Region<CellIdx>::all(board_->size()); }
+
+std::vector<Region<CellIdx>> RuleHandler::constraint_groups() const { return {watched_cells() | subscribed_cells()}; }
+
+} // namespace sudoku
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "../defs.h"
 #include "../impact_map.h"
 #include "../region/CellIdx.h"
+#include "../region/cell_lookup.h"
 #include "../region/region.h"
 #include "rule_utils.h"
 
@@ -15,14 +19,63 @@ public:
     virtual bool number_changed(CellIdx pos) = 0;
     virtual bool candidates_changed() = 0;
     virtual bool valid() = 0;
+
+    /**
+     * @brief Checks only the constraints containing at least one of the given cells.
+     *
+     * Called by the board after a placement was propagated, with every cell modified since. Constraints
+     * without a changed cell cannot have become violated. The default checks everything via valid().
+     * @param cells Cells modified since the placement
+     */
+    virtual bool valid_changed(const std::vector<CellIdx> &cells) { return valid(); }
     virtual void update_impact(ImpactMap &impact_map) = 0;
 
+    /**
+     * @brief Cells whose state candidates_changed() depends on.
+     *
+     * The board only wakes the handler after one of these cells changed. The default watches
+     * every cell; an empty region means the handler never needs to be woken.
+     */
+    virtual Region<CellIdx> watched_cells() const;
+
+    /**
+     * @brief Cells whose placement number_changed() reacts to.
+     *
+     * The board only calls number_changed() for these cells. The default subscribes to every cell.
+     */
+    virtual Region<CellIdx> subscribed_cells() const;
+
+    /**
+     * @brief Groups of cells the rule constrains together.
+     *
+     * Two unsolved cells can only restrict each other through this rule if some group contains
+     * both, and the rule holds once it holds for every group on its own. The default is a single
+     * group of the watched and subscribed cells.
+     */
+    virtual std::vector<Region<CellIdx>> constraint_groups() const;
+
     virtual void from_json(JSON &json) = 0;
     virtual JSON to_json() const = 0;
 
     virtual void init_randomly() = 0;
 
+    /**
+     * @brief Creates a copy of this handler bound to another board.
+     *
+     * The copy keeps the rule configuration of this handler; precomputed tables are shared.
+     * @param board Board the copy operates on
+     */
+    virtual std::shared_ptr<RuleHandler> clone(Board *board) const = 0;
+
 protected:
     Board *board_ = nullptr;
+
+    /// Copies a handler of concrete type T and rebinds the copy to the given board.
+    template<typename T>
+    static std::shared_ptr<RuleHandler> clone_to(const T &handler, Board *board) {
+        std::shared_ptr<RuleHandler> copy = std::make_shared<T>(handler);
+        copy->board_ = board;
+        return copy;
+    }
 };
 } // namespace sudoku
@@ -34,7 +34,7 @@ bool RuleAntiChess::number_changed(CellIdx pos) {
         if (!pair.enabled)
             continue;
 
-        if (pair.region.size() > 0 && !pair.region.has(pos))
+        if (!in_region(i, pos))
             continue; // skip if cell is not in the region
 
         changed |= check_cage(pair.region, pair.allow_repeats);
@@ -45,7 +45,7 @@ bool RuleAntiChess::number_changed(CellIdx pos) {
             if (!rule_utils::pos_in_bounds(board_, neighbor_pos))
                 continue; // skip out of bounds neighbors
 
-            if (pair.region.size() > 0 && !pair.region.has(neighbor_pos))
+            if (!in_region(i, neighbor_pos))
                 continue; // skip if neighbor is not in the region
 
             Cell &neighbor = board_->get_cell(neighbor_pos);
@@ -129,47 +129,55 @@ bool RuleAntiChess::valid() {
         if (!pair.enabled)
             continue;
 
-        const Region<CellIdx> &region = pair.region;
-        if (!is_cage_valid(region, pair.allow_repeats))
+        if (!is_cage_valid(pair.region, pair.allow_repeats))
             return false;
 
-        const attacks &move_pattern = (m_pair[i].label == "Anti-Knight") ? KNIGHT_PATTERN : KING_PATTERN;
+        for (int r = 0; r < board_size; r++)
+            for (int c = 0; c < board_size; c++)
+                if (!is_move_valid(i, {r, c}))
+                    return false;
+    }
 
-        for (int r = 0; r < board_size; r++) {
-            for (int c = 0; c < board_size; c++) {
-                CellIdx pos{r, c};
+    return true;
+}
 
-                Cell &cell = board_->get_cell(pos);
-                if (!cell.is_solved())
-                    continue;
+bool RuleAntiChess::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i = 0; i < 2; i++) {
+        const auto &pair = m_pair[i];
 
-                if (region.size() > 0 && !region.has(pos))
-                    continue; // skip if cell is not in the region
+        if (!pair.enabled)
+            continue;
 
-                for (const auto &attack: move_pattern) {
-                    CellIdx neighbor_pos{r + attack.first, c + attack.second};
-                    if (!rule_utils::pos_in_bounds(board_, neighbor_pos))
-                        continue;
+        if (!is_cage_valid(pair.region, pair.allow_repeats))
+            return false;
 
-                    if (region.size() > 0 && !region.has(neighbor_pos))
-                        continue; // skip if neighbor is not in the region
+        // attacks are symmetric, so every new conflict involves a changed cell
+        for (const auto &pos: cells)
+            if (!is_move_valid(i, pos))
+                return false;
+    }
 
-                    Cell &neighbor = board_->get_cell(neighbor_pos);
-                    if (!neighbor.is_solved())
-                        continue;
+    return true;
+}
 
-                    // if neighbor cell has the same value as the current cell, return false
-                    if (neighbor.value == cell.value)
-                        return false;
+Region<CellIdx> RuleAntiChess::watched_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &pair: m_pair)
+        if (pair.enabled)
+            cells = cells | pair.region;
+    return cells;
+}
 
-                    if (contains_sum(cell.value + neighbor.value, pair.forbidden_sums))
-                        return false;
-                }
-            }
-        }
+Region<CellIdx> RuleAntiChess::subscribed_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &pair: m_pair) {
+        if (!pair.enabled)
+            continue;
+        if (pair.region.size() == 0)
+            return Region<CellIdx>::all(board_->size()); // the pattern applies to the whole board
+        cells = cells | pair.region;
     }
-
-    return true;
+    return cells;
 }
 
 void RuleAntiChess::update_impact(ImpactMap &map) {
@@ -235,6 +243,8 @@ void RuleAntiChess::from_json(JSON &json) {
         if (count >= 2)
             break;
     }
+
+    build_lookup();
 }
 
 JSON RuleAntiChess::to_json() const {
@@ -270,8 +280,7 @@ JSON RuleAntiChess::to_json() const {
 }
 
 void RuleAntiChess::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
     std::uniform_real_distribution<> dis(0.0, 1.0);
 
     // reset
@@ -330,10 +339,18 @@ void RuleAntiChess::init_randomly() {
             m_pair[i].forbidden_sums.assign(unique_sums.begin(), unique_sums.end());
         }
     }
+
+    build_lookup();
 }
 
 // private member functions
 
+void RuleAntiChess::build_lookup() {
+    m_lookup.reset(board_->size());
+    for (int i = 0; i < 2; i++)
+        m_lookup.add(m_pair[i].region, i);
+}
+
 bool RuleAntiChess::is_cage_valid(const Region<CellIdx> &region, bool allow_repeats) {
     if (allow_repeats || region.size() == 0)
         return true;
@@ -352,6 +369,40 @@ bool RuleAntiChess::is_cage_valid(const Region<CellIdx> &region, bool allow_repe
     return true;
 }
 
+bool RuleAntiChess::is_move_valid(int pair_idx, const CellIdx &pos) {
+    const auto &pair = m_pair[pair_idx];
+
+    const Cell &cell = board_->get_cell(pos);
+    if (!cell.is_solved())
+        return true;
+
+    if (!in_region(pair_idx, pos))
+        return true; // skip if cell is not in the region
+
+    const attacks &move_pattern = (pair.label == "Anti-Knight") ? KNIGHT_PATTERN : KING_PATTERN;
+    for (const auto &attack: move_pattern) {
+        CellIdx neighbor_pos{pos.r + attack.first, pos.c + attack.second};
+        if (!rule_utils::pos_in_bounds(board_, neighbor_pos))
+            continue;
+
+        if (!in_region(pair_idx, neighbor_pos))
+            continue; // skip if neighbor is not in the region
+
+        const Cell &neighbor = board_->get_cell(neighbor_pos);
+        if (!neighbor.is_solved())
+            continue;
+
+        // if neighbor cell has the same value as the current cell, the move is invalid
+        if (neighbor.value == cell.value)
+            return false;
+
+        if (contains_sum(cell.value + neighbor.value, pair.forbidden_sums))
+            return false;
+    }
+
+    return true;
+}
+
 bool RuleAntiChess::check_cage(const Region<CellIdx> &region, bool allow_repeats) {
     if (allow_repeats || region.size() == 0)
         return false;
@@ -366,8 +417,10 @@ bool RuleAntiChess::check_cage(const Region<CellIdx> &region, bool allow_repeats
         Cell &cell = board_->get_cell(item);
 
         if (cell.is_solved()) {
-            if (seen_values.test(cell.value))
-                return false; // duplicate found
+            if (seen_values.test(cell.value)) {
+                board_->report_contradiction(); // duplicate found
+                return false;
+            }
             seen_values.add(cell.value);
         } else {
             m_remaining_cells.add(cell.pos);
@@ -13,6 +13,9 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,6 +23,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct AntiChessPair {
         std::string label;
@@ -39,12 +44,20 @@ private:
     // standard parameters
     AntiChessPair m_pair[2];
     Region<CellIdx> m_remaining_cells;
+    CellLookup m_lookup; ///< Pairs whose region contains each cell
 
     // private member functions
+    void build_lookup();
     bool is_cage_valid(const Region<CellIdx> &region, bool allow_repeats);
     bool check_cage(const Region<CellIdx> &region, bool allow_repeats);
+    bool is_move_valid(int pair_idx, const CellIdx &pos);
     bool enforce_forbidden_sums(const Cell &c1, Cell &c2, const AntiChessPair &pair);
 
+    // an empty region means the whole board
+    bool in_region(int pair, const CellIdx &pos) const {
+        return m_pair[pair].region.size() == 0 || m_lookup.has(pos, pair);
+    }
+
     bool contains_sum(int sum, const std::vector<int> &forbidden_sums) {
         if (forbidden_sums.empty())
             return false;
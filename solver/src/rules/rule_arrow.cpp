@@ -6,12 +6,8 @@ namespace sudoku {
 
 bool RuleArrow::number_changed(CellIdx pos) {
     bool changed = false;
-    for (auto &arrow_pair: m_arrow_pairs) {
-        const Region<CellIdx> &base = arrow_pair.base;
-        const Region<CellIdx> &path = arrow_pair.path;
-        // check if the changed cell is in the base or path
-        if (!base.has(pos) && !path.has(pos))
-            continue;
+    for (int i: m_lookup[pos]) {
+        ArrowPair &arrow_pair = m_arrow_pairs[i];
         changed |= determine_base_options(arrow_pair);
         changed |= determine_path_options(arrow_pair);
     }
@@ -28,20 +24,30 @@ bool RuleArrow::candidates_changed() {
 }
 
 bool RuleArrow::valid() {
-    for (const auto &arrow_pair: m_arrow_pairs) {
-        const Region<CellIdx> &base = arrow_pair.base;
-        const Region<CellIdx> &path = arrow_pair.path;
-
-        auto [base_lb, base_ub] = bounds_base(base, false);
-        auto [path_lb, path_ub] = bounds_path(path, base.size(), false);
-
-        if (base_ub < path_lb || base_lb > path_ub)
+    for (const auto &arrow_pair: m_arrow_pairs)
+        if (!valid_arrow(arrow_pair))
             return false;
-    }
+    return true;
+}
 
+bool RuleArrow::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_arrow(m_arrow_pairs[i]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleArrow::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleArrow::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleArrow::constraint_groups() const {
+    std::vector<Region<CellIdx>> groups;
+    for (const auto &pair: m_arrow_pairs)
+        groups.push_back(pair.base | pair.path);
+    return groups;
+}
+
 void RuleArrow::update_impact(ImpactMap &map) {
     for (const auto &arrow_pair: m_arrow_pairs) {
         const Region<CellIdx> &base = arrow_pair.base;
@@ -91,6 +97,8 @@ void RuleArrow::from_json(JSON &json) {
             m_arrow_pairs.push_back(arrow_pair);
         }
     }
+
+    build_lookup();
 }
 
 JSON RuleArrow::to_json() const {
@@ -119,8 +127,7 @@ void RuleArrow::init_randomly() {
     if (board_->size() != 9)
         return; // arrow rules only supported for 9x9 boards
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> arrow_dist(MIN_ARROWS, MAX_ARROWS);
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
@@ -170,10 +177,30 @@ void RuleArrow::init_randomly() {
             break;
         }
     }
+
+    build_lookup();
 }
 
 // private member functions
 
+void RuleArrow::build_lookup() {
+    m_lookup.reset(board_->size());
+    for (int i = 0; i < (int) m_arrow_pairs.size(); i++) {
+        m_lookup.add(m_arrow_pairs[i].base, i);
+        m_lookup.add(m_arrow_pairs[i].path, i);
+    }
+}
+
+bool RuleArrow::valid_arrow(const ArrowPair &arrow_pair) {
+    const Region<CellIdx> &base = arrow_pair.base;
+    const Region<CellIdx> &path = arrow_pair.path;
+
+    auto [base_lb, base_ub] = bounds_base(base, false);
+    auto [path_lb, path_ub] = bounds_path(path, base.size(), false);
+
+    return base_ub >= path_lb && base_lb <= path_ub;
+}
+
 bool RuleArrow::determine_base_options(ArrowPair &arrow_pair) {
     bool changed = false;
     Region<CellIdx> &base = arrow_pair.base;
@@ -13,6 +13,10 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,6 +24,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct ArrowPair {
         Region<CellIdx> base;
@@ -36,10 +42,13 @@ private:
 
     // standard parameter
     std::vector<ArrowPair> m_arrow_pairs;
+    CellLookup m_lookup; ///< Arrows touching each cell
 
     // private member functions
+    void build_lookup();
     bool determine_base_options(ArrowPair &arrow_pair);
     bool determine_path_options(ArrowPair &arrow_pair);
+    bool valid_arrow(const ArrowPair &arrow_pair);
 
     std::pair<int, int> bounds_base(const Region<CellIdx> &base, bool clip = true);
     std::pair<int, int> bounds_path(const Region<CellIdx> &path, int base_size, bool clip = true);
@@ -42,6 +42,17 @@ bool RuleChevron::valid() {
     return true;
 }
 
+Region<CellIdx> RuleChevron::watched_cells() const {
+    const int board_size = board_->size();
+    return m_up_edges.attached_cells(board_size) | m_down_edges.attached_cells(board_size) |
+           m_right_edges.attached_cells(board_size) | m_left_edges.attached_cells(board_size);
+}
+
+Region<CellIdx> RuleChevron::subscribed_cells() const {
+    // number_changed() does nothing
+    return {};
+}
+
 void RuleChevron::update_impact(ImpactMap &map) {
     for (const auto &edge: m_up_edges.items()) {
         map.increment({edge.r1, edge.c1});
@@ -122,8 +133,7 @@ JSON RuleChevron::to_json() const {
 }
 
 void RuleChevron::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> up_dist(MIN_UP_EDGES, MAX_UP_EDGES);
     const int num_up = up_dist(gen);
@@ -14,6 +14,8 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -21,6 +23,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     const int MIN_UP_EDGES = 1;
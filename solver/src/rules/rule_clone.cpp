@@ -9,24 +9,12 @@ bool RuleClone::number_changed(CellIdx pos) {
     bool changed = false;
     Cell &cell = board_->get_cell(pos);
 
-    for (const auto &group: m_units) {
+    for (const int changed_region_idx: m_lookup[pos]) {
+        const std::vector<int> &group = m_units[m_region_units[changed_region_idx]];
         if (group.size() < 2)
             continue;
 
-        // Find the region and position index containing our cell
-        int changed_region_idx = -1;
-        int changed_item_idx = -1;
-
-        for (const int region_idx: group) {
-            changed_item_idx = m_regions[region_idx].find_index(pos);
-            if (changed_item_idx != -1) {
-                changed_region_idx = region_idx;
-                break;
-            }
-        }
-
-        if (changed_region_idx == -1)
-            continue;
+        const int changed_item_idx = m_regions[changed_region_idx].find_index(pos);
 
         // process all other regions in the group
         for (const int region_idx: group) {
@@ -75,31 +63,23 @@ bool RuleClone::candidates_changed() {
 }
 
 bool RuleClone::valid() {
-    for (const auto &group: m_units) {
-        if (group.size() < 2)
-            continue;
-
-        const int region_size = m_regions[group.front()].size();
-        for (int item_idx = 0; item_idx < region_size; item_idx++) {
-            int first_value = -1;
-
-            for (const int region_idx: group) {
-                const Cell &cell = board_->get_cell(m_regions[region_idx].items()[item_idx]);
-
-                if (!cell.is_solved())
-                    continue;
-
-                if (first_value == -1)
-                    first_value = cell.value;
-                else if (cell.value != first_value)
-                    return false;
-            }
-        }
-    }
+    for (const auto &group: m_units)
+        if (!valid_group(group))
+            return false;
+    return true;
+}
 
+bool RuleClone::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int region_idx: m_lookup.touched(cells))
+        if (!valid_group(m_units[m_region_units[region_idx]]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleClone::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleClone::subscribed_cells() const { return m_lookup.cells(); }
+
 void RuleClone::update_impact(ImpactMap &map) {
     for (const auto &group: m_units) {
         if (group.size() < 2) // skip if no clone exists
@@ -145,7 +125,7 @@ JSON RuleClone::to_json() const {
 
         JSON fields = JSON(JSON::object{});
         fields["region"] = region.to_json();
-        fields["color"] = rule_utils::random_rgba_color();
+        fields["color"] = rule_utils::random_rgba_color(region);
 
         rule["fields"] = fields;
         rules.push_back(rule);
@@ -156,8 +136,7 @@ JSON RuleClone::to_json() const {
 }
 
 void RuleClone::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     m_regions.clear();
 
@@ -220,6 +199,30 @@ void RuleClone::init_randomly() {
 
 // private member function
 
+bool RuleClone::valid_group(const std::vector<int> &group) {
+    if (group.size() < 2)
+        return true;
+
+    const int region_size = m_regions[group.front()].size();
+    for (int item_idx = 0; item_idx < region_size; item_idx++) {
+        int first_value = -1;
+
+        for (const int region_idx: group) {
+            const Cell &cell = board_->get_cell(m_regions[region_idx].items()[item_idx]);
+
+            if (!cell.is_solved())
+                continue;
+
+            if (first_value == -1)
+                first_value = cell.value;
+            else if (cell.value != first_value)
+                return false;
+        }
+    }
+
+    return true;
+}
+
 void RuleClone::initCloneGroups() {
     m_units.clear();
 
@@ -254,6 +257,13 @@ void RuleClone::initCloneGroups() {
                       [](const CellIdx &a, const CellIdx &b) { return a.r < b.r || (a.r == b.r && a.c < b.c); });
         }
     }
+
+    m_region_units.assign(max_regions, 0);
+    for (int i = 0; i < (int) m_units.size(); i++)
+        for (int region_idx: m_units[i])
+            m_region_units[region_idx] = i;
+
+    m_lookup.build(board_->size(), m_regions);
 }
 
 bool RuleClone::isSameShape(const Region<CellIdx> &region1, const Region<CellIdx> &region2) {
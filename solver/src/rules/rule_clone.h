@@ -13,6 +13,9 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,6 +23,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     // min/max number of different clone groups
@@ -35,9 +40,12 @@ private:
     // standard parameters
     std::vector<Region<CellIdx>> m_regions;
     std::vector<std::vector<int>> m_units;
+    std::vector<int> m_region_units; ///< Group (index into m_units) of each region
+    CellLookup m_lookup; ///< Regions touching each cell
 
     // private member functions
     void initCloneGroups();
+    bool valid_group(const std::vector<int> &group);
     bool isSameShape(const Region<CellIdx> &region1, const Region<CellIdx> &region2);
 };
 
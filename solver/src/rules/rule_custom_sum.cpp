@@ -6,8 +6,7 @@ namespace sudoku {
 void RuleCustomSum::init_randomly() {
     m_pairs.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> pair_count_dist(MIN_PAIRS, MAX_PAIRS);
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
@@ -28,6 +27,8 @@ void RuleCustomSum::init_randomly() {
         int sum = sum_dist(gen);
         m_pairs.push_back({path, sum});
     }
+
+    build_lookup();
 }
 
 } // namespace sudoku
@@ -11,6 +11,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     const int MIN_PAIRS = 1;
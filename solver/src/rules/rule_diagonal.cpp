@@ -42,6 +42,23 @@ bool RuleDiagonal::valid() {
     return true;
 }
 
+Region<CellIdx> RuleDiagonal::watched_cells() const {
+    // candidates_changed() has nothing to do
+    return {};
+}
+
+Region<CellIdx> RuleDiagonal::subscribed_cells() const {
+    const int board_size = board_->size();
+    Region<CellIdx> cells;
+    for (int i = 0; i < board_size; ++i) {
+        if (m_main_diagonal)
+            cells.add({i, i});
+        if (m_anti_diagonal)
+            cells.add({i, board_size - 1 - i});
+    }
+    return cells;
+}
+
 void RuleDiagonal::from_json(JSON &json) {
     if (json["fields"].is_object() && json["fields"].get<JSON::object>().count("diagonal"))
         m_main_diagonal = json["fields"]["diagonal"].get<bool>();
@@ -62,8 +79,7 @@ JSON RuleDiagonal::to_json() const {
 }
 
 void RuleDiagonal::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
     std::uniform_real_distribution<double> dis(0.0, 1.0);
 
     if (dis(gen) < BOTH_DIAGONALS_EXIST_CHANCE) {
@@ -13,6 +13,8 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override {};
 
     void from_json(JSON &json) override;
@@ -20,6 +22,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameter
     double BOTH_DIAGONALS_EXIST_CHANCE = 0.5;
@@ -10,10 +10,10 @@ bool RuleDiagonalSum::number_changed(CellIdx pos) {
 
     bool changed = false;
     for (auto &pair: m_pairs) {
-        if (pair.region.has(main))
-            changed |= check_diagonal(main, pair.sum);
-        if (pair.region.has(anti))
-            changed |= check_diagonal(anti, pair.sum);
+        if (const int i = pair.region.find_index(main); i >= 0)
+            changed |= check_diagonal(pair.lines[i], pair.sum);
+        if (const int i = pair.region.find_index(anti); i >= 0)
+            changed |= check_diagonal(pair.lines[i], pair.sum);
     }
     return changed;
 }
@@ -21,16 +21,14 @@ bool RuleDiagonalSum::number_changed(CellIdx pos) {
 bool RuleDiagonalSum::candidates_changed() {
     bool changed = false;
     for (auto &pair: m_pairs)
-        for (const auto &diag: pair.region)
-            changed |= check_diagonal(diag, pair.sum);
+        for (const auto &line: pair.lines)
+            changed |= check_diagonal(line, pair.sum);
     return changed;
 };
 
 bool RuleDiagonalSum::valid() {
     for (const auto &pair: m_pairs) {
-        for (const auto &diag: pair.region) {
-            const std::vector<CellIdx> &cell_pos = diag.attached_cells(board_->size());
-
+        for (const auto &cell_pos: pair.lines) {
             bool all_solved = true;
             int sum = 0;
             for (const auto &pos: cell_pos) {
@@ -53,6 +51,15 @@ bool RuleDiagonalSum::valid() {
     return true;
 }
 
+Region<CellIdx> RuleDiagonalSum::watched_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &pair: m_pairs)
+        cells = cells | pair.region.attached_cells(board_->size());
+    return cells;
+}
+
+Region<CellIdx> RuleDiagonalSum::subscribed_cells() const { return watched_cells(); }
+
 void RuleDiagonalSum::update_impact(ImpactMap &map) {
     const int board_size = board_->size();
     for (const auto &pair: m_pairs) {
@@ -91,6 +98,8 @@ void RuleDiagonalSum::from_json(JSON &json) {
             m_pairs.push_back(pair);
         }
     }
+
+    resolve_lines();
 }
 
 JSON RuleDiagonalSum::to_json() const {
@@ -117,8 +126,7 @@ JSON RuleDiagonalSum::to_json() const {
 void RuleDiagonalSum::init_randomly() {
     m_pairs.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     const int board_size = board_->size();
 
@@ -140,7 +148,7 @@ void RuleDiagonalSum::init_randomly() {
 
         int region_attempts = 0;
         while ((int) region.size() < region_size && region_attempts++ < 25) {
-            DiagonalType type = (rand() % 2 == 0) ? DiagonalType::MAIN : DiagonalType::ANTI;
+            DiagonalType type = std::bernoulli_distribution(0.5)(gen) ? DiagonalType::MAIN : DiagonalType::ANTI;
             int index = index_dist(gen);
 
             DiagonalIdx diag(type, index);
@@ -157,15 +165,24 @@ void RuleDiagonalSum::init_randomly() {
         std::uniform_int_distribution<int> sum_dist(min_length, max_length * board_->size());
 
         int sum = sum_dist(gen);
-        m_pairs.push_back({region, sum});
+        m_pairs.push_back({region, sum, {}});
     }
+
+    resolve_lines();
 }
 
 // private member function
 
-bool RuleDiagonalSum::check_diagonal(const DiagonalIdx &diag, const int pair_sum) {
+void RuleDiagonalSum::resolve_lines() {
+    for (auto &pair: m_pairs) {
+        pair.lines.clear();
+        for (const auto &diag: pair.region)
+            pair.lines.push_back(diag.attached_cells(board_->size()));
+    }
+}
+
+bool RuleDiagonalSum::check_diagonal(const std::vector<CellIdx> &cells_pos, const int pair_sum) {
     const int board_size = board_->size();
-    const std::vector<CellIdx> &cells_pos = diag.attached_cells(board_size);
 
     int reamining_size = 0;
     int sum = 0;
@@ -13,6 +13,8 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,10 +22,13 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct DiagSumPair {
         Region<DiagonalIdx> region;
         int sum = 0;
+        std::vector<std::vector<CellIdx>> lines; ///< Cells of every diagonal of the region, resolved when loaded
     };
 
     // hyperparameters
@@ -36,7 +41,8 @@ private:
     std::vector<DiagSumPair> m_pairs;
 
     // private member functions
-    bool check_diagonal(const DiagonalIdx &diag, const int pair_sum);
+    void resolve_lines();
+    bool check_diagonal(const std::vector<CellIdx> &cells_pos, const int pair_sum);
     int diagonal_length(const DiagonalIdx &diag) const;
 };
 
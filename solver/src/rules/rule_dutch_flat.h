@@ -27,6 +27,8 @@ public:
 
     void init_randomly() override {}
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     bool enforce_dutch_flat(CellIdx pos);
 
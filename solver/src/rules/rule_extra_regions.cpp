@@ -8,11 +8,8 @@ bool RuleExtraRegions::number_changed(CellIdx pos) {
     Cell &cell = board_->get_cell(pos);
     bool changed = false;
 
-    for (const auto &region: m_regions) {
-        if (!region.has(pos))
-            continue;
-
-        for (const auto &item: region.items()) {
+    for (int i: m_lookup[pos]) {
+        for (const auto &item: m_regions[i].items()) {
             Cell &target = board_->get_cell(item);
             if (!target.is_solved())
                 changed |= target.remove_candidate(cell.value);
@@ -25,30 +22,28 @@ bool RuleExtraRegions::number_changed(CellIdx pos) {
 bool RuleExtraRegions::candidates_changed() { return false; }
 
 bool RuleExtraRegions::valid() {
-    const int board_size = board_->size();
-
-    for (auto &region: m_regions) {
-        NumberSet seen(board_size);
-        NumberSet combined(board_size);
-
-        for (const auto &pos: region) {
-            Cell &cell = board_->get_cell(pos);
-
-            if (cell.is_solved()) {
-                if (seen.test(cell.value))
-                    return false;
-                seen.add(cell.value);
-                combined |= NumberSet(cell.max_number, cell.value);
-            } else {
-                combined |= cell.get_candidates();
-            }
-        }
+    for (const auto &region: m_regions)
+        if (!valid_region(region))
+            return false;
+    return true;
+}
 
-        return combined.count() >= (int) region.size();
-    }
+bool RuleExtraRegions::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_region(m_regions[i]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleExtraRegions::watched_cells() const {
+    // candidates_changed() has nothing to do
+    return {};
+}
+
+Region<CellIdx> RuleExtraRegions::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleExtraRegions::constraint_groups() const { return m_regions; }
+
 void RuleExtraRegions::update_impact(ImpactMap &map) {
     for (const auto &region: m_regions) {
         for (const auto &item: region.items()) {
@@ -76,6 +71,8 @@ void RuleExtraRegions::from_json(JSON &json) {
         if (region.size() > 0)
             m_regions.push_back(region);
     }
+
+    m_lookup.build(board_->size(), m_regions);
 }
 
 JSON RuleExtraRegions::to_json() const {
@@ -89,7 +86,7 @@ JSON RuleExtraRegions::to_json() const {
         JSON fields = JSON(JSON::object{});
 
         fields["region"] = region.to_json();
-        fields["color"] = rule_utils::random_rgba_color();
+        fields["color"] = rule_utils::random_rgba_color(region);
 
         rule["fields"] = fields;
         rules.push_back(rule);
@@ -102,8 +99,7 @@ JSON RuleExtraRegions::to_json() const {
 void RuleExtraRegions::init_randomly() {
     m_regions.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> num_regions_dis(MIN_NUM_REGIONS, MAX_NUM_REGIONS);
     int num_regions = num_regions_dis(gen);
@@ -119,6 +115,32 @@ void RuleExtraRegions::init_randomly() {
         if (region.size() > 0)
             m_regions.push_back(region);
     }
+
+    m_lookup.build(board_->size(), m_regions);
+}
+
+// private member functions
+
+bool RuleExtraRegions::valid_region(const Region<CellIdx> &region) {
+    const int board_size = board_->size();
+
+    NumberSet seen(board_size);
+    NumberSet combined(board_size);
+
+    for (const auto &pos: region) {
+        Cell &cell = board_->get_cell(pos);
+
+        if (cell.is_solved()) {
+            if (seen.test(cell.value))
+                return false;
+            seen.add(cell.value);
+            combined |= NumberSet(cell.max_number, cell.value);
+        } else {
+            combined |= cell.get_candidates();
+        }
+    }
+
+    return combined.count() >= (int) region.size();
 }
 
 } // namespace sudoku
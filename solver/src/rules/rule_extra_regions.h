@@ -13,6 +13,10 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,6 +24,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     const int MIN_NUM_REGIONS = 1;
@@ -27,6 +33,10 @@ private:
 
     // standard parameter
     std::vector<Region<CellIdx>> m_regions;
+    CellLookup m_lookup; ///< Regions touching each cell
+
+    // private member functions
+    bool valid_region(const Region<CellIdx> &region);
 };
 
 } // namespace sudoku
@@ -6,22 +6,13 @@ namespace sudoku {
 
 bool RuleIrregularRegions::number_changed(CellIdx pos) {
     Cell &cell = board_->get_cell(pos);
-    bool changed = false;
-
     NumberSet rm(cell.max_number, cell.value);
 
-    for (auto &c: board_->get_row(pos.r))
-        if (!c->is_solved())
-            changed |= c->remove_candidates(rm);
-    for (auto &c: board_->get_col(pos.c))
-        if (!c->is_solved())
-            changed |= c->remove_candidates(rm);
-
-    for (const auto &region: m_regions) {
-        if (!region.has(pos))
-            continue;
+    // the row and column come first in the peer list, the regions replace the blocks
+    bool changed = rule_utils::eliminate_peers(board_, pos, 2 * (board_->size() - 1));
 
-        for (const auto &item: region.items()) {
+    for (int i: m_lookup[pos]) {
+        for (const auto &item: m_regions[i].items()) {
             Cell &target = board_->get_cell(item);
             if (!target.is_solved())
                 changed |= target.remove_candidates(rm);
@@ -62,24 +53,48 @@ bool RuleIrregularRegions::valid() {
     return true;
 }
 
+bool RuleIrregularRegions::valid_changed(const std::vector<CellIdx> &cells) {
+    const int board_size = board_->size();
+
+    // only the units containing a changed cell can have become invalid
+    uint32_t rows = 0, cols = 0;
+    for (const auto &pos: cells) {
+        rows |= 1u << pos.r;
+        cols |= 1u << pos.c;
+    }
+
+    for (int i = 0; i < board_size; i++) {
+        if ((rows >> i & 1) && !rule_utils::is_group_valid(board_->get_row(i)))
+            return false;
+        if ((cols >> i & 1) && !rule_utils::is_group_valid(board_->get_col(i)))
+            return false;
+    }
+
+    for (int i: m_lookup.touched(cells))
+        if (!rule_utils::is_group_valid(m_irregular_units[i]))
+            return false;
+
+    return true;
+}
+
 void RuleIrregularRegions::from_json(JSON &json) {
     m_regions.clear();
-    m_irregular_units.clear();
 
     for (int i = 1; i <= 9; ++i) {
         std::string region_key = "region" + std::to_string(i);
         Region<CellIdx> region = Region<CellIdx>::from_json(json["fields"][region_key]);
-        if (region.size() > 0) {
+        if (region.size() > 0)
             m_regions.push_back(region);
-            // create a unit for each region
-            std::vector<Cell *> unit;
-            for (const auto &pos: region.items()) {
-                Cell &cell = board_->get_cell(pos);
-                unit.push_back(&cell);
-            }
-            m_irregular_units.push_back(unit);
-        }
     }
+
+    build_units();
+}
+
+std::shared_ptr<RuleHandler> RuleIrregularRegions::clone(Board *board) const {
+    auto copy = std::make_shared<RuleIrregularRegions>(board);
+    copy->m_regions = m_regions;
+    copy->build_units();
+    return copy;
 }
 
 JSON RuleIrregularRegions::to_json() const {
@@ -97,4 +112,19 @@ JSON RuleIrregularRegions::to_json() const {
     return json;
 }
 
+// private member functions
+
+void RuleIrregularRegions::build_units() {
+    // create a unit for each region
+    m_irregular_units.clear();
+    for (const auto &region: m_regions) {
+        std::vector<Cell *> unit;
+        for (const auto &pos: region.items())
+            unit.push_back(&board_->get_cell(pos));
+        m_irregular_units.push_back(unit);
+    }
+
+    m_lookup.build(board_->size(), m_regions);
+}
+
 } // namespace sudoku
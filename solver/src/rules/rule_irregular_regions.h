@@ -13,6 +13,7 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
     void update_impact(ImpactMap &map) override {};
 
     void from_json(JSON &json) override;
@@ -20,9 +21,14 @@ public:
 
     void init_randomly() override { assert(false); }
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override;
+
 private:
     std::vector<Region<CellIdx>> m_regions;
     std::vector<std::vector<Cell *>> m_irregular_units;
+    CellLookup m_lookup; ///< Regions touching each cell
+
+    void build_units();
 };
 
 } // namespace sudoku
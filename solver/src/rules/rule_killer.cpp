@@ -4,16 +4,9 @@
 namespace sudoku {
 
 bool RuleKiller::number_changed(CellIdx pos) {
-    bool changed = false;
-    for (auto &pair: m_pairs) {
-        const Region<CellIdx> &region = pair.region;
-        if (!region.has(pos))
-            continue;
-
-        changed |= check_cage(pair);
-        break; // regions can't overlap
-    }
-    return changed;
+    const std::vector<int> &cages = m_lookup[pos];
+    // regions can't overlap, so only the first cage containing the cell matters
+    return !cages.empty() && check_cage(m_pairs[cages.front()]);
 }
 
 bool RuleKiller::candidates_changed() {
@@ -24,32 +17,28 @@ bool RuleKiller::candidates_changed() {
 }
 
 bool RuleKiller::valid() {
-    for (const auto &pair: m_pairs) {
-        int sum = 0;
-        NumberSet seen_values(board_->size());
-        bool all_solved = true;
-
-        for (const auto &item: pair.region) {
-            const Cell &cell = board_->get_cell(item);
+    for (const auto &pair: m_pairs)
+        if (!is_cage_valid(pair))
+            return false;
+    return true;
+}
 
-            if (!cell.is_solved()) {
-                all_solved = false;
-                continue;
-            }
+bool RuleKiller::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!is_cage_valid(m_pairs[i]))
+            return false;
+    return true;
+}
 
-            sum += cell.value;
+Region<CellIdx> RuleKiller::watched_cells() const { return m_lookup.cells(); }
 
-            if (!m_number_can_repeat) {
-                if (seen_values.test(cell.value))
-                    return false;
-                seen_values.add(cell.value);
-            }
-        }
+Region<CellIdx> RuleKiller::subscribed_cells() const { return m_lookup.cells(); }
 
-        if (sum > pair.sum || (all_solved && sum != pair.sum))
-            return false;
-    }
-    return true;
+std::vector<Region<CellIdx>> RuleKiller::constraint_groups() const {
+    std::vector<Region<CellIdx>> groups;
+    for (const auto &pair: m_pairs)
+        groups.push_back(pair.region);
+    return groups;
 }
 
 void RuleKiller::from_json(JSON &json) {
@@ -77,6 +66,8 @@ void RuleKiller::from_json(JSON &json) {
             m_pairs.push_back(cage_pair);
         }
     }
+
+    build_lookup();
 }
 
 JSON RuleKiller::to_json() const {
@@ -106,6 +97,37 @@ JSON RuleKiller::to_json() const {
 
 // private member functions
 
+void RuleKiller::build_lookup() {
+    m_lookup.reset(board_->size());
+    for (int i = 0; i < (int) m_pairs.size(); i++)
+        m_lookup.add(m_pairs[i].region, i);
+}
+
+bool RuleKiller::is_cage_valid(const KillerPair &pair) {
+    int sum = 0;
+    NumberSet seen_values(board_->size());
+    bool all_solved = true;
+
+    for (const auto &item: pair.region) {
+        const Cell &cell = board_->get_cell(item);
+
+        if (!cell.is_solved()) {
+            all_solved = false;
+            continue;
+        }
+
+        sum += cell.value;
+
+        if (!m_number_can_repeat) {
+            if (seen_values.test(cell.value))
+                return false;
+            seen_values.add(cell.value);
+        }
+    }
+
+    return sum <= pair.sum && (!all_solved || sum == pair.sum);
+}
+
 bool RuleKiller::check_cage(KillerPair &pair) {
     const int board_size = board_->size();
     m_remaining_cells.clear();
@@ -125,8 +147,10 @@ bool RuleKiller::check_cage(KillerPair &pair) {
             if (m_number_can_repeat)
                 continue; // repetition allowed, no need to check
 
-            if (seen.test(cell.value))
+            if (seen.test(cell.value)) {
+                board_->report_contradiction(); // duplicate in the cage
                 return false;
+            }
             seen.add(cell.value);
         } else {
             m_remaining_cells.add(cell.pos);
@@ -141,14 +165,17 @@ bool RuleKiller::check_cage(KillerPair &pair) {
     auto [min, max] = rule_utils::getSoftBounds(m_remaining_cells.size(), pair.sum - sum, min_cand, max_cand,
                                                 board_size, m_number_can_repeat);
 
+    // digits within the bounds that are not placed in the cage yet
+    NumberSet allowed(board_size);
+    if (min <= max)
+        allowed = NumberSet::lessEqThan(board_size, std::clamp(max, 0, board_size)) -
+                  NumberSet::lessThan(board_size, std::clamp(min, 0, board_size));
+    if (!m_number_can_repeat)
+        allowed -= seen;
+
     bool changed = false;
-    for (const auto &pos: m_remaining_cells) {
-        Cell &cell = board_->get_cell(pos);
-        for (const auto n: cell.candidates) {
-            if ((!m_number_can_repeat && seen.test(n)) || n < min || n > max)
-                changed |= cell.remove_candidate(n);
-        }
-    }
+    for (const auto &pos: m_remaining_cells)
+        changed |= board_->get_cell(pos).only_allow_candidates(allowed);
 
     return changed;
 }
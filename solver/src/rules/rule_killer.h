@@ -13,6 +13,10 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override {};
 
     void from_json(JSON &json) override;
@@ -20,6 +24,8 @@ public:
 
     void init_randomly() override { assert(false); }
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct KillerPair {
         Region<CellIdx> region;
@@ -32,9 +38,13 @@ private:
 
     // private member function
     bool check_cage(KillerPair &pair);
+    bool is_cage_valid(const KillerPair &pair);
 
 protected:
     std::string name = "Killer";
     std::vector<KillerPair> m_pairs; // used by RuleCustomSum
+    CellLookup m_lookup; ///< Cages touching each cell
+
+    void build_lookup(); // call after m_pairs changed
 };
 } // namespace sudoku
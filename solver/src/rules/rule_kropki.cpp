@@ -57,6 +57,19 @@ bool RuleKropki::valid() {
     return true;
 }
 
+Region<CellIdx> RuleKropki::watched_cells() const {
+    const int board_size = board_->size();
+    Region<CellIdx> cells = m_white_edges.attached_cells(board_size) | m_black_edges.attached_cells(board_size);
+    if (m_all_dots_given)
+        cells = cells | m_missing_edges.attached_cells(board_size);
+    return cells;
+}
+
+Region<CellIdx> RuleKropki::subscribed_cells() const {
+    // number_changed() does nothing
+    return {};
+}
+
 void RuleKropki::update_impact(ImpactMap &map) {
     for (const auto &edge: m_white_edges.items()) {
         map.increment({edge.r1, edge.c1});
@@ -250,10 +263,9 @@ JSON RuleKropki::to_json() const {
 }
 
 void RuleKropki::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
-    m_all_dots_given = rand() % 2 == 0;
+    m_all_dots_given = std::bernoulli_distribution(0.5)(gen);
 
     std::uniform_int_distribution<int> white_dist(MIN_WHITE_EDGES, MAX_WHITE_EDGES);
     const int num_white = white_dist(gen);
@@ -21,8 +21,7 @@ const std::array<std::array<int, 9>, 8> MAGIC_SQUARE_SOLUTIONS =
 // clang-format on
 
 Region<CellIdx> generate_3x3_region(Board *board, Region<CellIdx> *available_region) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board->rng();
 
     Region<CellIdx> region;
 
@@ -96,6 +95,19 @@ bool RuleMagic::valid() {
     return true;
 }
 
+bool RuleMagic::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells)) {
+        initPossibleLayouts(m_regions[i]);
+        if (m_possible_layouts.empty())
+            return false;
+    }
+    return true;
+}
+
+Region<CellIdx> RuleMagic::watched_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleMagic::constraint_groups() const { return m_regions; }
+
 void RuleMagic::from_json(JSON &json) {
     m_regions.clear();
 
@@ -124,6 +136,8 @@ void RuleMagic::from_json(JSON &json) {
             m_regions.push_back(region);
         }
     }
+
+    m_lookup.build(board_->size(), m_regions);
 }
 
 JSON RuleMagic::to_json() const {
@@ -155,8 +169,7 @@ void RuleMagic::init_randomly() {
 
     assert(MAX_MAGIC_SQUARES > 9);
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<> dis(MIN_MAGIC_SQUARES, MAX_MAGIC_SQUARES);
     int magic_squares_count = dis(gen);
@@ -173,6 +186,8 @@ void RuleMagic::init_randomly() {
         if (attempts > 100)
             break; // prevent infinite loop if not enough space
     }
+
+    m_lookup.build(board_->size(), m_regions);
 }
 
 // private member functions
@@ -213,8 +228,10 @@ void RuleMagic::initPossibleLayouts(const Region<CellIdx> &region) {
 
 bool RuleMagic::applyCandidates(const Region<CellIdx> &region) {
     initPossibleLayouts(region);
-    if (m_possible_layouts.empty())
+    if (m_possible_layouts.empty()) {
+        board_->report_contradiction(); // no magic square fits the region anymore
         return false;
+    }
 
     bool changed = false;
 
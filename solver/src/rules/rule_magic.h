@@ -15,6 +15,9 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override {};
 
     void from_json(JSON &json) override;
@@ -22,6 +25,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     const int MIN_MAGIC_SQUARES = 1;
@@ -30,6 +35,7 @@ private:
     // standard parameters
     std::vector<Region<CellIdx>> m_regions;
     std::vector<std::array<int, 9>> m_possible_layouts;
+    CellLookup m_lookup; ///< Regions touching each cell
 
     // private member functions
     bool is3x3Square(const Region<CellIdx> &region);
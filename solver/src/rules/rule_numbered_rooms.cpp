@@ -57,6 +57,15 @@ bool RuleNumberedRooms::valid() {
     return true;
 }
 
+Region<CellIdx> RuleNumberedRooms::watched_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &pair: m_pairs)
+        cells = cells | pair.region.attached_cells(board_->size());
+    return cells;
+}
+
+Region<CellIdx> RuleNumberedRooms::subscribed_cells() const { return watched_cells(); }
+
 void RuleNumberedRooms::update_impact(ImpactMap &map) {
     for (const auto &pair: m_pairs) {
         for (const auto &orc: pair.region) {
@@ -140,8 +149,7 @@ JSON RuleNumberedRooms::to_json() const {
 void RuleNumberedRooms::init_randomly() {
     m_pairs.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     const int board_size = board_->size();
 
@@ -150,6 +158,8 @@ void RuleNumberedRooms::init_randomly() {
 
     std::uniform_int_distribution<int> digit_dist(2, board_size);
     std::uniform_int_distribution<int> region_size_dist(MIN_REGION_SIZE, MAX_REGION_SIZE);
+    std::uniform_int_distribution<int> line_dist(0, board_size - 1);
+    std::bernoulli_distribution coin_dist(0.5);
 
     Region<ORCIdx> occupied_region; // use this so regions don't overlap
 
@@ -161,12 +171,12 @@ void RuleNumberedRooms::init_randomly() {
         int region_attempts = 0;
         while ((int) region.size() < region_size && region_attempts++ < 25) {
             int r = -1, c = -1;
-            if (rand() % 2 == 0)
-                r = rand() % board_size; // use row
+            if (coin_dist(gen))
+                r = line_dist(gen); // use row
             else
-                c = rand() % board_size; // use col
+                c = line_dist(gen); // use col
 
-            bool reversed = (rand() % 2 == 0);
+            bool reversed = coin_dist(gen);
 
             ORCIdx orc(r, c, reversed);
             if (occupied_region.has(orc))
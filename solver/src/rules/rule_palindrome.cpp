@@ -63,6 +63,15 @@ bool RulePalindrome::valid() {
     return true;
 }
 
+Region<CellIdx> RulePalindrome::watched_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &path: m_paths)
+        cells = cells | path;
+    return cells;
+}
+
+std::vector<Region<CellIdx>> RulePalindrome::constraint_groups() const { return m_paths; }
+
 void RulePalindrome::update_impact(ImpactMap &map) {
     for (auto &path: m_paths) {
         for (const auto &pos: path) {
@@ -116,8 +125,7 @@ JSON RulePalindrome::to_json() const {
 void RulePalindrome::init_randomly() {
     m_paths.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> path_count_dist(MIN_PATHS, MAX_PATHS);
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
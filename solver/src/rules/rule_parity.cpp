@@ -5,11 +5,8 @@ namespace sudoku {
 
 bool RuleParity::number_changed(CellIdx pos) {
     bool changed = false;
-    for (const auto &path: m_paths) {
-        if (!path.has(pos))
-            continue;
-        changed |= enforceParityAlternation(path);
-    }
+    for (int i: m_lookup[pos])
+        changed |= enforceParityAlternation(m_paths[i]);
     return changed;
 }
 
@@ -21,22 +18,25 @@ bool RuleParity::candidates_changed() {
 }
 
 bool RuleParity::valid() {
-    for (const auto &path: m_paths) {
-        const std::vector<CellIdx> &items = path.items();
-
-        for (size_t i = 0; i < items.size(); ++i) {
-            Cell &cell = board_->get_cell(items[i]);
-            if (cell.is_solved())
-                continue;
-
-            if (cell.candidates.count() == 0)
-                return false;
-        }
-    }
+    for (const auto &path: m_paths)
+        if (!valid_path(path))
+            return false;
+    return true;
+}
 
+bool RuleParity::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_path(m_paths[i]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleParity::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleParity::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleParity::constraint_groups() const { return m_paths; }
+
 void RuleParity::update_impact(ImpactMap &map) {
     for (const auto &path: m_paths) {
         for (const auto &pos: path) {
@@ -65,6 +65,8 @@ void RuleParity::from_json(JSON &json) {
         if (path.size() > 1) // only accept paths with more than 1 cell
             m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 JSON RuleParity::to_json() const {
@@ -92,8 +94,7 @@ JSON RuleParity::to_json() const {
 void RuleParity::init_randomly() {
     m_paths.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
     std::uniform_int_distribution<int> path_count_dist(MIN_PATHS, MAX_PATHS);
@@ -111,10 +112,27 @@ void RuleParity::init_randomly() {
             continue; // skip paths that are too short
         m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 // private member functions
 
+bool RuleParity::valid_path(const Region<CellIdx> &path) {
+    const std::vector<CellIdx> &items = path.items();
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        Cell &cell = board_->get_cell(items[i]);
+        if (cell.is_solved())
+            continue;
+
+        if (cell.candidates.count() == 0)
+            return false;
+    }
+
+    return true;
+}
+
 bool RuleParity::enforceParityAlternation(const Region<CellIdx> &path) {
     bool changed = false;
 
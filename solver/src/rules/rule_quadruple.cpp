@@ -5,32 +5,28 @@ namespace sudoku {
 
 bool RuleQuadruple::number_changed(CellIdx pos) {
     bool changed = false;
-    for (const auto &pair: m_pairs) {
-        Region<CellIdx> region_cells = pair.region.attached_cells();
-        if (!region_cells.has(pos))
-            continue;
+    for (int i: m_lookup[pos]) {
+        const QuadruplePair &pair = m_pairs[i];
 
         NumberSet missing = pair.values;
-        for (const auto &pos: region_cells) {
+        for (const auto &pos: pair.cells) {
             Cell &cell = board_->get_cell(pos);
             if (cell.is_solved())
                 missing.remove(cell.value);
         }
 
-        Region<CellIdx> candidates;
-        for (const auto &pos: region_cells) {
-            Cell &cell = board_->get_cell(pos);
-            if (cell.is_solved())
-                continue;
+        // unsolved cells that can still take a missing value
+        auto takes_missing = [&](const Cell &cell) { return !cell.is_solved() && (cell.candidates & missing).count() > 0; };
 
-            if ((cell.candidates & missing).count() > 0)
-                candidates.add(pos);
-        }
+        int candidates = 0;
+        for (const auto &pos: pair.cells)
+            candidates += takes_missing(board_->get_cell(pos));
 
-        if ((int) candidates.size() == missing.count()) {
-            for (const auto &pos: candidates) {
+        if (candidates == missing.count()) {
+            for (const auto &pos: pair.cells) {
                 Cell &cell = board_->get_cell(pos);
-                changed = cell.only_allow_candidates(missing);
+                if (takes_missing(cell))
+                    changed = cell.only_allow_candidates(missing);
             }
         }
     }
@@ -44,25 +40,40 @@ bool RuleQuadruple::candidates_changed() {
 }
 
 bool RuleQuadruple::valid() {
-    for (const auto &pair: m_pairs) {
-        Region<CellIdx> region_cells = pair.region.attached_cells();
-
-        int value_count = 0;
-        for (const CellIdx &pos: region_cells)
-            value_count += (board_->get_cell(pos).candidates & pair.values).count() > 0;
-
-        if (value_count < pair.values.count())
+    for (const auto &pair: m_pairs)
+        if (!valid_pair(pair))
             return false;
-    }
+    return true;
+}
 
+bool RuleQuadruple::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_pair(m_pairs[i]))
+            return false;
     return true;
 }
 
-void RuleQuadruple::update_impact(ImpactMap &map) {
+Region<CellIdx> RuleQuadruple::watched_cells() const {
+    // candidates_changed() has nothing to do
+    return {};
+}
+
+Region<CellIdx> RuleQuadruple::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleQuadruple::constraint_groups() const {
+    std::vector<Region<CellIdx>> groups;
     for (const auto &pair: m_pairs) {
-        Region<CellIdx> region_cells = pair.region.attached_cells();
-        map.increment_region(region_cells, 1);
+        Region<CellIdx> &group = groups.emplace_back();
+        for (const auto &pos: pair.cells)
+            group.add(pos);
     }
+    return groups;
+}
+
+void RuleQuadruple::update_impact(ImpactMap &map) {
+    for (const auto &pair: m_pairs)
+        for (const auto &pos: pair.cells)
+            map.increment(pos);
 }
 
 void RuleQuadruple::from_json(JSON &json) {
@@ -89,9 +100,11 @@ void RuleQuadruple::from_json(JSON &json) {
                 }
             }
 
-            m_pairs.push_back({region, values_set});
+            m_pairs.push_back({region, values_set, {}});
         }
     }
+
+    resolve_cells();
 }
 
 JSON RuleQuadruple::to_json() const {
@@ -122,8 +135,7 @@ JSON RuleQuadruple::to_json() const {
 void RuleQuadruple::init_randomly() {
     m_pairs.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     const int board_size = board_->size();
 
@@ -146,8 +158,30 @@ void RuleQuadruple::init_randomly() {
         for (int i = 0; i < value_size; i++)
             values.add(value_dist(gen));
 
-        m_pairs.push_back({region, values});
+        m_pairs.push_back({region, values, {}});
+    }
+
+    resolve_cells();
+}
+
+// private member functions
+
+bool RuleQuadruple::valid_pair(const QuadruplePair &pair) {
+    int value_count = 0;
+    for (const CellIdx &pos: pair.cells)
+        value_count += (board_->get_cell(pos).candidates & pair.values).count() > 0;
+
+    return value_count >= pair.values.count();
+}
+
+void RuleQuadruple::resolve_cells() {
+    m_lookup.reset(board_->size());
+    for (int i = 0; i < (int) m_pairs.size(); i++) {
+        QuadruplePair &pair = m_pairs[i];
+        pair.cells = pair.region.attached_cells(board_->size()).items();
+        for (const auto &pos: pair.cells)
+            m_lookup.add(pos, i);
     }
-};
+}
 
 } // namespace sudoku
@@ -13,6 +13,10 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,10 +24,13 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct QuadruplePair {
         Region<CornerIdx> region;
         NumberSet values;
+        std::vector<CellIdx> cells; ///< Cells around the corners, resolved when loaded
     };
 
     // hyperparameters
@@ -32,6 +39,11 @@ private:
 
     // standard parameter
     std::vector<QuadruplePair> m_pairs;
+    CellLookup m_lookup; ///< Quadruples touching each cell
+
+    // private member functions
+    void resolve_cells();
+    bool valid_pair(const QuadruplePair &pair);
 };
 
 } // namespace sudoku
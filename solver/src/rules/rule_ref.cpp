@@ -0,0 +1,37 @@
+#include "rule_ref.h"
+#include "../board/board.h"
+#include "include.h"
+
+#include <type_traits>
+#include <typeinfo>
+
+namespace sudoku {
+
+namespace {
+
+template<typename Rule, typename... Rest>
+RuleRef exact_ref(RuleHandler *handler) {
+    if constexpr (sizeof...(Rest) == 0) {
+        static_assert(std::is_same_v<Rule, RuleHandler>, "RuleHandler must be the last alternative");
+        return handler;
+    } else {
+        if (typeid(*handler) == typeid(Rule))
+            return static_cast<Rule *>(handler);
+        return exact_ref<Rest...>(handler);
+    }
+}
+
+template<typename... Rules>
+RuleRef make_ref(RuleHandler *handler, std::variant<Rules *...> *) {
+    return exact_ref<Rules...>(handler);
+}
+
+} // namespace
+
+RuleRef make_rule_ref(RuleHandler *handler) {
+    if (!handler)
+        return handler;
+    return make_ref(handler, static_cast<RuleRef *>(nullptr));
+}
+
+} // namespace sudoku
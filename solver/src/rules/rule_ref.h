@@ -0,0 +1,63 @@
+/**
+ * @file rule_ref.h
+ * @brief Typed handle to a rule handler of the closed set of built-in rules.
+ *
+ * This file is part of the SudokuSolver project, developed for the Sudoku Website.
+ * The board stores its handlers as RuleHandler pointers, but the set of rule types is closed.
+ * A RuleRef remembers the exact type of a handler, so the propagation loop can call a rule
+ * through std::visit without going through the vtable, and with link-time optimization the
+ * small rules can be inlined into it. Handlers of other types fall back to virtual calls.
+ *
+ * @date 2025-05-16
+ * @author Finn Eggers
+ */
+
+#pragma once
+
+#include <variant>
+
+namespace sudoku {
+
+class RuleHandler;
+class RuleAntiChess;
+class RuleArrow;
+class RuleChevron;
+class RuleClone;
+class RuleCustomSum;
+class RuleDiagonal;
+class RuleDiagonalSum;
+class RuleDutchFlat;
+class RuleExtraRegions;
+class RuleIrregularRegions;
+class RuleKiller;
+class RuleKropki;
+class RuleMagic;
+class RuleNumberedRooms;
+class RulePalindrome;
+class RuleParity;
+class RuleQuadruple;
+class RuleRenban;
+class RuleSandwich;
+class RuleStandard;
+class RuleThermo;
+class RuleWhisper;
+class RuleWildApples;
+class RuleXV;
+
+/**
+ * @brief Pointer to a handler by its exact type. The last alternative holds handlers of any other
+ * type (and null handlers).
+ */
+using RuleRef = std::variant<RuleAntiChess *, RuleArrow *, RuleChevron *, RuleClone *, RuleCustomSum *, RuleDiagonal *,
+                             RuleDiagonalSum *, RuleDutchFlat *, RuleExtraRegions *, RuleIrregularRegions *,
+                             RuleKiller *, RuleKropki *, RuleMagic *, RuleNumberedRooms *, RulePalindrome *,
+                             RuleParity *, RuleQuadruple *, RuleRenban *, RuleSandwich *, RuleStandard *, RuleThermo *,
+                             RuleWhisper *, RuleWildApples *, RuleXV *, RuleHandler *>;
+
+/**
+ * @brief Returns the typed handle of a handler. Only an exact type match selects a built-in
+ * alternative, so a subclass of a built-in rule keeps its overrides.
+ */
+RuleRef make_rule_ref(RuleHandler *handler);
+
+} // namespace sudoku
@@ -5,11 +5,8 @@ namespace sudoku {
 
 bool RuleRenban::number_changed(CellIdx pos) {
     bool changed = false;
-    for (const auto &path: m_paths) {
-        if (!path.has(pos))
-            continue;
-        changed |= enforce_renban(path);
-    }
+    for (int i: m_lookup[pos])
+        changed |= enforce_renban(m_paths[i]);
     return changed;
 }
 
@@ -20,6 +17,12 @@ bool RuleRenban::candidates_changed() {
     return changed;
 }
 
+Region<CellIdx> RuleRenban::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleRenban::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleRenban::constraint_groups() const { return m_paths; }
+
 void RuleRenban::update_impact(ImpactMap &map) {
     for (const auto &path: m_paths) {
         for (const auto &pos: path) {
@@ -32,27 +35,16 @@ void RuleRenban::update_impact(ImpactMap &map) {
 }
 
 bool RuleRenban::valid() {
-    for (const auto &path: m_paths) {
-        NumberSet solved_values(board_->size());
-        for (const auto &pos: path) {
-            const Cell &cell = board_->get_cell(pos);
-            if (!cell.is_solved())
-                continue;
-
-            if (solved_values.test(cell.value))
-                return false; // duplicate value in path
-            solved_values.add(cell.value);
-        }
-
-        int path_size = path.size();
-        if (solved_values.count() != path_size)
-            continue;
-
-        int dist = solved_values.highest() - solved_values.lowest() + 1;
-        if (dist != path_size)
+    for (const auto &path: m_paths)
+        if (!valid_path(path))
             return false;
-    }
+    return true;
+}
 
+bool RuleRenban::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_path(m_paths[i]))
+            return false;
     return true;
 }
 
@@ -72,6 +64,8 @@ void RuleRenban::from_json(JSON &json) {
         if (path.size() > 1)
             m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 JSON RuleRenban::to_json() const {
@@ -98,8 +92,7 @@ JSON RuleRenban::to_json() const {
 void RuleRenban::init_randomly() {
     m_paths.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
     std::uniform_int_distribution<int> path_count_dist(MIN_PATHS, MAX_PATHS);
@@ -117,10 +110,32 @@ void RuleRenban::init_randomly() {
             continue; // skip paths that are too short
         m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 // private member functions
 
+bool RuleRenban::valid_path(const Region<CellIdx> &path) {
+    NumberSet solved_values(board_->size());
+    for (const auto &pos: path) {
+        const Cell &cell = board_->get_cell(pos);
+        if (!cell.is_solved())
+            continue;
+
+        if (solved_values.test(cell.value))
+            return false; // duplicate value in path
+        solved_values.add(cell.value);
+    }
+
+    int path_size = path.size();
+    if (solved_values.count() != path_size)
+        return true; // not fully solved yet
+
+    int dist = solved_values.highest() - solved_values.lowest() + 1;
+    return dist == path_size;
+}
+
 bool RuleRenban::enforce_renban(const Region<CellIdx> &path) {
     const int board_size = board_->size();
     const int length = path.size();
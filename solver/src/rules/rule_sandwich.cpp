@@ -3,11 +3,6 @@
 
 namespace sudoku {
 
-RuleSandwich::~RuleSandwich() {
-    delete[] m_min_digits;
-    delete[] m_max_digits;
-}
-
 bool RuleSandwich::number_changed(CellIdx pos) {
     bool changed = false;
     for (const auto &pair: m_pairs) {
@@ -31,6 +26,15 @@ bool RuleSandwich::candidates_changed() {
     return changed;
 };
 
+Region<CellIdx> RuleSandwich::watched_cells() const {
+    Region<CellIdx> cells;
+    for (const auto &pair: m_pairs)
+        cells = cells | pair.region.attached_cells(board_->size());
+    return cells;
+}
+
+Region<CellIdx> RuleSandwich::subscribed_cells() const { return watched_cells(); }
+
 void RuleSandwich::update_impact(ImpactMap &map) {
     for (const auto &pair: m_pairs) {
         const Region<RCIdx> &region = pair.region;
@@ -123,8 +127,7 @@ JSON RuleSandwich::to_json() const {
 void RuleSandwich::init_randomly() {
     m_pairs.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     const int board_size = board_->size();
 
@@ -132,6 +135,8 @@ void RuleSandwich::init_randomly() {
     const int num_pairs = pairs_dist(gen);
 
     std::uniform_int_distribution<int> region_size_dist(MIN_REGION_SIZE, MAX_REGION_SIZE);
+    std::uniform_int_distribution<int> line_dist(0, board_size - 1);
+    std::bernoulli_distribution coin_dist(0.5);
     std::uniform_int_distribution<int> sum_dist(1, (board_size - 2) * (board_size + 1) / 2);
 
     Region<RCIdx> occupied_region; // use this so regions don't overlap
@@ -144,10 +149,10 @@ void RuleSandwich::init_randomly() {
         int region_attempts = 0;
         while ((int) region.size() < region_size && region_attempts++ < 25) {
             int r = -1, c = -1;
-            if (rand() % 2 == 0)
-                r = rand() % board_size; // use row
+            if (coin_dist(gen))
+                r = line_dist(gen); // use row
             else
-                c = rand() % board_size; // use column
+                c = line_dist(gen); // use column
 
             RCIdx pos(r, c);
             if (occupied_region.has(pos))
@@ -170,16 +175,14 @@ void RuleSandwich::initTables() {
     const int board_size = board_->size();
     const int max_sum = (board_size * (board_size + 1)) / 2;
 
-    m_union_sets.assign(max_sum + 1, std::vector<NumberSet>(board_size + 1, NumberSet(board_size)));
-    m_min_digits = new int[max_sum + 1]();
-    m_max_digits = new int[max_sum + 1]();
-
-    std::fill(m_min_digits, m_min_digits + max_sum + 1, board_size + 1);
+    auto tables = std::make_shared<Tables>();
+    tables->union_sets.assign(max_sum + 1, std::vector<NumberSet>(board_size + 1, NumberSet(board_size)));
+    tables->min_digits.assign(max_sum + 1, board_size + 1);
+    tables->max_digits.assign(max_sum + 1, 0);
 
     // Generate all digit combinations excluding 1 and board_size
     for (int mask = 1; mask < (1 << board_size); mask++) {
-        const NumberSet::bit_t bits = mask << 1;
-        NumberSet cands(board_size, bits);
+        NumberSet cands(board_size, static_cast<NumberSet::bit_t>(mask));
 
         int sum = 0, count = 0;
         for (int d = 1; d <= board_size; ++d) {
@@ -193,9 +196,9 @@ void RuleSandwich::initTables() {
         }
 
         if (count > 0 && sum <= max_sum) {
-            m_union_sets[sum][count] |= cands;
-            m_min_digits[sum] = std::min(m_min_digits[sum], count);
-            m_max_digits[sum] = std::max(m_max_digits[sum], count);
+            tables->union_sets[sum][count] |= cands;
+            tables->min_digits[sum] = std::min(tables->min_digits[sum], count);
+            tables->max_digits[sum] = std::max(tables->max_digits[sum], count);
         }
 
     next_mask:;
@@ -203,14 +206,16 @@ void RuleSandwich::initTables() {
 
     // Reset impossible sums
     for (int s = 0; s <= max_sum; s++)
-        if (m_min_digits[s] > board_size)
-            m_min_digits[s] = m_max_digits[s] = 0;
+        if (tables->min_digits[s] > board_size)
+            tables->min_digits[s] = tables->max_digits[s] = 0;
+
+    m_tables = std::move(tables);
 }
 
 bool RuleSandwich::check_unkown_digits(int idx1, int idxBoardSize, const RCIdx &pos, const int sum) {
     const int board_size = board_->size();
-    const int minD = m_min_digits[sum];
-    const int maxD = m_max_digits[sum];
+    const int minD = m_tables->min_digits[sum];
+    const int maxD = m_tables->max_digits[sum];
 
     const std::vector<Cell *> &line = get_line(pos);
 
@@ -261,13 +266,13 @@ bool RuleSandwich::check_known_digits(int idx1, int idxBoardSize, const RCIdx &p
     const int right = std::max(idx1, idxBoardSize);
     const int between = right - left - 1;
 
-    if (between < m_min_digits[sum] || between > m_max_digits[sum]) {
+    if (between < m_tables->min_digits[sum] || between > m_tables->max_digits[sum]) {
         return false;
     }
 
     bool changed = false;
 
-    const NumberSet &valid_digits = m_union_sets[sum][between];
+    const NumberSet &valid_digits = m_tables->union_sets[sum][between];
     for (int i = left + 1; i < right; i++) {
         Cell &c = *line[i];
         if (c.is_solved())
@@ -285,8 +290,8 @@ bool RuleSandwich::check_known_digit(int idx1, int idxBoardSize, const RCIdx &po
     const int board_size = board_->size();
     const std::vector<Cell *> &line = get_line(pos);
 
-    const int minD = m_min_digits[sum];
-    const int maxD = m_max_digits[sum];
+    const int minD = m_tables->min_digits[sum];
+    const int maxD = m_tables->max_digits[sum];
 
     const int known_idx = (idx1 != -1) ? idx1 : idxBoardSize;
     const int unknown_digit = (idx1 != -1) ? board_size : 1;
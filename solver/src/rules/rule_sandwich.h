@@ -9,11 +9,12 @@ namespace sudoku {
 class RuleSandwich : public RuleHandler {
 public:
     explicit RuleSandwich(Board *board) : RuleHandler(board) {}
-    ~RuleSandwich();
 
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -21,6 +22,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     struct SandwichPair {
         Region<RCIdx> region;
@@ -33,11 +36,15 @@ private:
     const int MIN_REGION_SIZE = 1;
     const int MAX_REGION_SIZE = 3;
 
-    // standard parameters
-    int *m_min_digits;
-    int *m_max_digits;
+    // lookup tables per sum; immutable once built and shared between clones
+    struct Tables {
+        std::vector<int> min_digits;
+        std::vector<int> max_digits;
+        std::vector<std::vector<NumberSet>> union_sets;
+    };
 
-    std::vector<std::vector<NumberSet>> m_union_sets;
+    // standard parameters
+    std::shared_ptr<const Tables> m_tables;
     std::vector<SandwichPair> m_pairs;
 
     // private member functions
@@ -1,25 +1,108 @@
 #include "rule_standard.h"
 #include "../board/board.h"
+#include "../board/singles.h"
+
+#include <array>
 
 namespace sudoku {
 
-// RuleStandard methods
+namespace {
+
+/**
+ * @brief A unit is valid if no number is placed twice and every number still fits somewhere.
+ */
+template<typename G>
+bool unit_valid(const Board &board, int u) {
+    if (const DigitBoard *digits = board.digit_board())
+        return digits->unit_valid(u);
+
+    const auto &unit = G::units[u];
+
+    NumberSet seen;
+    NumberSet combined;
+    for (int i = 0; i < G::SIZE; i++) {
+        const Cell &cell = board.get_cell(unit[i]);
+        if (cell.is_solved()) {
+            if (seen.test(cell.value))
+                return false;
+            seen.add(cell.value);
+            combined.add(cell.value);
+        } else {
+            combined |= cell.candidates;
+        }
+    }
+    return combined.raw() == G::MASK;
+}
+
+/**
+ * @brief Pointing: a number confined to one row (column) of a block is removed from the rest of
+ * that row (column).
+ *
+ * The candidates of every row and column segment of a block are collected first, so a number
+ * points if it appears in exactly one segment. Blocks are processed in order.
+ */
+template<typename G>
+bool pointing(Board &board) {
+    auto segment = [&board](const auto &cells) {
+        NumberSet res;
+        for (const auto idx: cells) {
+            const Cell &cell = board.get_cell(idx);
+            if (!cell.is_solved())
+                res |= cell.candidates;
+        }
+        return res;
+    };
+
+    // numbers of each segment that appear in no other segment of the same block
+    auto confined = [](const std::array<NumberSet, G::BLOCK> &segments, int k) {
+        NumberSet others;
+        for (int j = 0; j < G::BLOCK; j++)
+            if (j != k)
+                others |= segments[j];
+        return segments[k] - others;
+    };
 
-bool RuleStandard::number_changed(CellIdx pos) {
-    auto &cell = board_->get_cell(pos);
     bool changed = false;
+    for (int b = 0; b < G::SIZE; b++) {
+        std::array<NumberSet, G::BLOCK> rows;
+        std::array<NumberSet, G::BLOCK> cols;
+        for (int k = 0; k < G::BLOCK; k++) {
+            rows[k] = segment(G::box_rows[b][k]);
+            cols[k] = segment(G::box_cols[b][k]);
+        }
 
-    NumberSet rm(cell.max_number, cell.value);
+        for (int k = 0; k < G::BLOCK; k++) {
+            const NumberSet row_pointing = confined(rows, k);
+            if (row_pointing.count())
+                for (const auto idx: G::row_rest[b][k])
+                    changed |= board.get_cell(idx).remove_candidates(row_pointing);
 
-    for (auto &c: board_->get_row(pos.r))
-        if (!c->is_solved())
-            changed |= c->remove_candidates(rm);
-    for (auto &c: board_->get_col(pos.c))
-        if (!c->is_solved())
-            changed |= c->remove_candidates(rm);
-    for (auto &c: board_->get_block(pos.r, pos.c))
-        if (!c->is_solved())
-            changed |= c->remove_candidates(rm);
+            const NumberSet col_pointing = confined(cols, k);
+            if (col_pointing.count())
+                for (const auto idx: G::col_rest[b][k])
+                    changed |= board.get_cell(idx).remove_candidates(col_pointing);
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+// RuleStandard methods
+
+bool RuleStandard::number_changed(CellIdx pos) {
+    bool changed = false;
+    if (const DigitBoard *digits = board_->digit_board()) {
+        // only visit the unsolved peers that still allow the placed number
+        const int idx = board_->flat_index(pos);
+        const Number value = board_->get_cell(idx).value;
+        const NumberSet rm(board_->size(), value);
+        ((digits->digit(value) & digits->peers(idx)) - digits->solved()).for_each([&](int peer) {
+            changed |= board_->get_cell(peer).remove_candidates(rm);
+        });
+    } else {
+        changed = rule_utils::eliminate_peers(board_, pos, board_->geometry().peers);
+    }
 
     if (board_->use_smart_hints()) {
         changed |= apply_pointing();
@@ -29,23 +112,26 @@ bool RuleStandard::number_changed(CellIdx pos) {
 }
 
 bool RuleStandard::candidates_changed() {
+    // all rows, columns and blocks are scanned for singles at once; placing the forced digits can
+    // create new singles, so the scan repeats until nothing changes
     bool changed = false;
-    const int board_size = board_->size();
+    for (bool progress = true; progress;) {
+        Singles singles;
+        dispatch_size(board_->size(), [this, &singles](auto geometry) {
+            find_singles<decltype(geometry)>(board_->candidate_data(), board_->value_data(), singles);
+        });
+
+        if (singles.conflict) {
+            board_->report_contradiction(); // one cell is the only place for two numbers
+            return false;
+        }
 
-    for (int i = 0; i < board_size; i++) {
-        auto row = board_->get_row(i);
-        auto col = board_->get_col(i);
-        changed |= rule_utils::hidden_singles(board_, row);
-        changed |= rule_utils::hidden_singles(board_, col);
+        progress = false;
+        for (const int idx: singles.cells)
+            progress |= board_->get_cell(idx).only_allow_candidates(singles.digits[idx]);
+        changed |= progress;
     }
 
-    const int block_size = board_->block_size();
-    for (int br = 0; br < board_size; br += block_size)
-        for (int bc = 0; bc < board_size; bc += block_size) {
-            auto block = board_->get_block(br, bc);
-            changed |= rule_utils::hidden_singles(board_, block);
-        }
-
     if (board_->use_smart_hints()) {
         changed |= apply_pointing();
     }
@@ -54,87 +140,54 @@ bool RuleStandard::candidates_changed() {
 }
 
 bool RuleStandard::valid() {
-    const int board_size = board_->size();
-    for (int i = 0; i < board_size; i++) {
-        if (!rule_utils::is_group_valid(board_->get_row(i)))
-            return false;
-        if (!rule_utils::is_group_valid(board_->get_col(i)))
-            return false;
-    }
-
-    const int block_size = board_->block_size();
-    for (int br = 0; br < board_size; br += block_size)
-        for (int bc = 0; bc < board_size; bc += block_size)
-            if (!rule_utils::is_group_valid(board_->get_block(br, bc)))
+    return dispatch_size(board_->size(), [this](auto geometry) {
+        using G = decltype(geometry);
+        for (int u = 0; u < G::UNITS; u++)
+            if (!unit_valid<G>(*board_, u))
                 return false;
+        return true;
+    });
+}
 
-    return true;
+bool RuleStandard::valid_changed(const std::vector<CellIdx> &cells) {
+    return dispatch_size(board_->size(), [&](auto geometry) {
+        using G = decltype(geometry);
+
+        // only the units containing a changed cell can have become invalid
+        std::array<bool, G::UNITS> dirty{};
+        for (const auto &pos: cells)
+            for (int k = 0; k < (G::HAS_BLOCKS ? 3 : 2); k++)
+                dirty[G::cell_units[pos.r * G::SIZE + pos.c][k]] = true;
+
+        for (int u = 0; u < G::UNITS; u++)
+            if (dirty[u] && !unit_valid<G>(*board_, u))
+                return false;
+        return true;
+    });
 }
 
+std::vector<Region<CellIdx>> RuleStandard::constraint_groups() const {
+    // every row, column and block on its own
+    const GeometryView &geometry = board_->geometry();
+    std::vector<Region<CellIdx>> groups(geometry.units);
+    for (int u = 0; u < geometry.units; u++) {
+        const auto *cells = geometry.unit(u);
+        for (int i = 0; i < geometry.size; i++)
+            groups[u].add({cells[i] / geometry.size, cells[i] % geometry.size});
+    }
+    return groups;
+}
 
 // ---------------------------------------------
 // PRIVATE MEMBER FUNCTION
 // ---------------------------------------------
 bool RuleStandard::apply_pointing() {
-    bool changed = false;
-    const int board_size = board_->size();
-    const int block_size = board_->block_size();
-    const int max_val = board_size;
-
-    for (int br = 0; br < board_size; br += block_size) {
-        for (int bc = 0; bc < board_size; bc += block_size) {
-            auto &block = board_->get_block(br, bc);
-
-            // Track which row and column each number appears in
-            std::vector<int> row_of(max_val + 1, -1);
-            std::vector<int> col_of(max_val + 1, -1);
-
-            for (auto* cell : block) {
-                if (cell->is_solved()) continue;
-                const Row r = cell->pos.r;
-                const Col c = cell->pos.c;
-
-                for (Number n : cell->get_candidates()) {
-                    // Row tracking
-                    if (row_of[n] == -1) {
-                        row_of[n] = r;
-                    } else if (row_of[n] != r) {
-                        row_of[n] = board_size; // invalid
-                    }
-
-                    // Col tracking
-                    if (col_of[n] == -1) {
-                        col_of[n] = c;
-                    } else if (col_of[n] != c) {
-                        col_of[n] = board_size; // invalid
-                    }
-                }
-            }
-
-            // Eliminate from rows or columns outside the block
-            for (Number n = 1; n <= max_val; ++n) {
-                if (row_of[n] >= 0 && row_of[n] < board_size) {
-                    for (auto* cell : board_->get_row(row_of[n])) {
-                        if (!cell->is_solved() &&
-                            !(std::find(block.begin(), block.end(), cell) != block.end())) {
-                            changed |= cell->remove_candidate(n);
-                        }
-                    }
-                }
-
-                if (col_of[n] >= 0 && col_of[n] < board_size) {
-                    for (auto* cell : board_->get_col(col_of[n])) {
-                        if (!cell->is_solved() &&
-                            !(std::find(block.begin(), block.end(), cell) != block.end())) {
-                            changed |= cell->remove_candidate(n);
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    return changed;
+    return dispatch_size(board_->size(), [this](auto geometry) {
+        using G = decltype(geometry);
+        if constexpr (G::HAS_BLOCKS)
+            return pointing<G>(*board_);
+        return false;
+    });
 }
 
 } // namespace sudoku
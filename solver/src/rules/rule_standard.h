@@ -13,6 +13,8 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override {};
 
     void from_json(JSON &json) override {};
@@ -27,6 +29,8 @@ public:
 
     void init_randomly() override {}
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
 
     bool apply_pointing();
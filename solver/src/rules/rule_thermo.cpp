@@ -7,10 +7,9 @@ bool RuleThermo::number_changed(CellIdx pos) {
     bool changed = false;
     Cell &cell = board_->get_cell(pos);
 
-    for (const auto &path: m_paths) {
+    for (int i: m_lookup[pos]) {
+        const Region<CellIdx> &path = m_paths[i];
         const int idx = path.find_index(pos);
-        if (idx == -1)
-            continue;
 
         const int path_size = path.size();
         const std::vector<CellIdx> &items = path.items();
@@ -72,21 +71,25 @@ bool RuleThermo::candidates_changed() {
 }
 
 bool RuleThermo::valid() {
-    for (const auto &path: m_paths) {
-        const std::vector<CellIdx> &items = path.items();
-
-        for (size_t i = 1; i < items.size(); ++i) {
-            Cell &a = board_->get_cell(items[i - 1]);
-            Cell &b = board_->get_cell(items[i]);
-
-            if (a.is_solved() && b.is_solved() && a.value >= b.value)
-                return false;
-        }
-    }
+    for (const auto &path: m_paths)
+        if (!valid_path(path))
+            return false;
+    return true;
+}
 
+bool RuleThermo::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_path(m_paths[i]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleThermo::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleThermo::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleThermo::constraint_groups() const { return m_paths; }
+
 void RuleThermo::update_impact(ImpactMap &map) {
     for (const auto &path: m_paths) {
         const std::vector<CellIdx> &items = path.items();
@@ -120,6 +123,8 @@ void RuleThermo::from_json(JSON &json) {
         if (path.size() > 1) // only accept paths with more than 1 cell
             m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 JSON RuleThermo::to_json() const {
@@ -146,8 +151,7 @@ JSON RuleThermo::to_json() const {
 void RuleThermo::init_randomly() {
     m_paths.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
     std::uniform_int_distribution<int> path_count_dist(MIN_PATHS, MAX_PATHS);
@@ -165,6 +169,24 @@ void RuleThermo::init_randomly() {
             continue; // skip paths that are too short
         m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
+}
+
+// private member functions
+
+bool RuleThermo::valid_path(const Region<CellIdx> &path) {
+    const std::vector<CellIdx> &items = path.items();
+
+    for (size_t i = 1; i < items.size(); ++i) {
+        Cell &a = board_->get_cell(items[i - 1]);
+        Cell &b = board_->get_cell(items[i]);
+
+        if (a.is_solved() && b.is_solved() && a.value >= b.value)
+            return false;
+    }
+
+    return true;
 }
 
 } // namespace sudoku
@@ -5,13 +5,13 @@ namespace sudoku::rule_utils {
 
 // helper to select random element without removing
 template<typename T>
-T select_random(const Region<T> &vec, std::mt19937 &gen) {
+T select_random(const Region<T> &vec, Rng &gen) {
     std::uniform_int_distribution<> dist(0, vec.size() - 1);
     return vec.items()[dist(gen)];
 }
 
 // helper to find a valid starting point in the board
-CellIdx find_valid_starting_cell(Board *board, std::mt19937 &gen, const Region<CellIdx> &available_region = {}) {
+CellIdx find_valid_starting_cell(Board *board, Rng &gen, const Region<CellIdx> &available_region = {}) {
     if (available_region.size() == 0) {
         std::uniform_int_distribution<> dist(0, board->size() - 1);
         return {dist(gen), dist(gen)};
@@ -61,18 +61,29 @@ bool hidden_singles(Board *board_, std::vector<Cell *> &unit) {
         seen_once |= c->candidates;
     }
 
-    NumberSet unique = seen_once & ~seen_twice;
+    NumberSet unique = seen_once - seen_twice;
 
     for (auto &c: unit)
         if (!c->is_solved()) {
             NumberSet pick = c->get_candidates() & unique;
             if (pick.count() == 1)
-                changed |= c->remove_candidates(~pick);
+                changed |= c->only_allow_candidates(pick);
         }
 
     return changed;
 }
 
+bool eliminate_peers(Board *board, const CellIdx &pos, int count) {
+    const int idx = board->flat_index(pos);
+    const NumberSet rm(board->size(), board->get_cell(idx).value);
+    const auto *peers = board->geometry().peers_of(idx);
+
+    bool changed = false;
+    for (int i = 0; i < count; ++i)
+        changed |= board->get_cell(peers[i]).remove_candidates(rm);
+    return changed;
+}
+
 std::pair<int, int> getSoftBounds(int N, int sum, int minC, int maxC, int size, bool number_can_repeat_) {
     // Compute min bound
     int min = size + 1;
@@ -113,9 +124,13 @@ std::pair<int, int> getSoftBounds(int N, int sum, int minC, int maxC, int size,
     return {min, max};
 }
 
-std::string random_rgba_color() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+std::string random_rgba_color(const Region<CellIdx> &region) {
+    // a generator of its own, seeded from the cells: a region keeps its colour and serializing a
+    // board never advances the board's generator
+    uint64_t key = 0;
+    for (const CellIdx &cell: region.items())
+        key = key * 131 + cell.r * 64 + cell.c;
+    Rng gen = make_rng(key);
     std::uniform_int_distribution<> dis(0, 255);
     std::uniform_real_distribution<> alpha_dis(0.2, 0.4);
 
@@ -154,8 +169,7 @@ Region<CellIdx> get_all_neighbors(Board *board, const CellIdx &cell) {
 }
 
 Region<CellIdx> generate_random_region(Board *board, const int max_region_size, Region<CellIdx> *available_region) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board->rng();
 
     CellIdx current = available_region ? find_valid_starting_cell(board, gen, *available_region)
                                        : find_valid_starting_cell(board, gen);
@@ -188,8 +202,7 @@ Region<CellIdx> generate_random_region(Board *board, const int max_region_size,
 }
 
 Region<CellIdx> generate_random_path(Board *board, const int max_path_size, Region<CellIdx> *available_path) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board->rng();
 
     CellIdx current = available_path ? find_valid_starting_cell(board, gen, *available_path)
                                      : find_valid_starting_cell(board, gen);
@@ -219,8 +232,7 @@ Region<CellIdx> generate_random_path(Board *board, const int max_path_size, Regi
 }
 
 Region<EdgeIdx> generate_random_edges(Board *board, const int max_edge_count, Region<EdgeIdx> &available_edges) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board->rng();
 
     Region<EdgeIdx> edges;
 
@@ -237,8 +249,7 @@ Region<EdgeIdx> generate_random_edges(Board *board, const int max_edge_count, Re
 
 Region<CornerIdx> generate_random_corners(Board *board, const int max_corner_count,
                                           Region<CornerIdx> &available_corners) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board->rng();
 
     Region<CornerIdx> corners;
 
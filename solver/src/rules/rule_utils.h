@@ -4,6 +4,7 @@
 #include <vector>
 #include "../cell.h"
 #include "../region/region.h"
+#include "../rng.h"
 
 namespace sudoku::rule_utils {
 
@@ -30,15 +31,23 @@ bool is_group_valid(const std::vector<Cell *> &unit);
  */
 bool hidden_singles(Board *board_, std::vector<Cell *> &unit);
 
+/**
+ * @brief Removes the value of a solved cell from the first `count` cells of its peer list.
+ *
+ * Peers are listed row first, then column, then the rest of the block (see Geometry::peers), so
+ * 2 * (size - 1) restricts the elimination to the row and column.
+ */
+bool eliminate_peers(Board *board, const CellIdx &pos, int count);
+
 /**
  * @brief Computes the minimum and maximum possible values for a cell in a sum constraint.
  */
 std::pair<int, int> getSoftBounds(int N, int sum, int minC, int maxC, int size, bool number_can_repeat_ = true);
 
 /**
- * @brief generates a random color in RGBA format.
+ * @brief generates a random color in RGBA format, always the same one for the same region.
  */
-std::string random_rgba_color();
+std::string random_rgba_color(const Region<CellIdx> &region);
 
 /**
  * @brief Get all orthogonal neighbors of a cell.
@@ -50,6 +59,8 @@ Region<CellIdx> get_orthogonal_neighbors(Board *board, const CellIdx &cell);
  */
 Region<CellIdx> get_all_neighbors(Board *board, const CellIdx &cell);
 
+// the generate_random_* functions draw from board->rng(), so they are reproducible for a given seed
+
 /**
  * @brief Generate a random, connected region of given size inside available_region.
  * @param max_region_size The region may not reach this size if no more cells are available.
@@ -5,9 +5,8 @@ namespace sudoku {
 
 bool RuleWhisper::number_changed(CellIdx pos) {
     bool changed = false;
-    for (const auto &path: m_paths) {
-        if (!path.has(pos))
-            continue;
+    for (int path_idx: m_lookup[pos]) {
+        const Region<CellIdx> &path = m_paths[path_idx];
 
         const auto &items = path.items();
         for (size_t i = 0; i < path.size() - 1; i++) {
@@ -39,20 +38,25 @@ bool RuleWhisper::candidates_changed() {
 }
 
 bool RuleWhisper::valid() {
-    for (const auto &path: m_paths) {
-        const auto &items = path.items();
-        for (size_t i = 0; i < path.size() - 1; i++) {
-            Cell &cell1 = board_->get_cell(items[i]);
-            Cell &cell2 = board_->get_cell(items[i + 1]);
-
-            if (!valid_pair(cell1, cell2))
-                return false;
-        }
-    }
+    for (const auto &path: m_paths)
+        if (!valid_path(path))
+            return false;
+    return true;
+}
 
+bool RuleWhisper::valid_changed(const std::vector<CellIdx> &cells) {
+    for (int i: m_lookup.touched(cells))
+        if (!valid_path(m_paths[i]))
+            return false;
     return true;
 }
 
+Region<CellIdx> RuleWhisper::watched_cells() const { return m_lookup.cells(); }
+
+Region<CellIdx> RuleWhisper::subscribed_cells() const { return m_lookup.cells(); }
+
+std::vector<Region<CellIdx>> RuleWhisper::constraint_groups() const { return m_paths; }
+
 void RuleWhisper::update_impact(ImpactMap &map) {
     for (const auto &path: m_paths) {
         for (const auto &pos: path) {
@@ -80,6 +84,8 @@ void RuleWhisper::from_json(JSON &json) {
         if (path.size() > 1)
             m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 JSON RuleWhisper::to_json() const {
@@ -106,8 +112,7 @@ JSON RuleWhisper::to_json() const {
 void RuleWhisper::init_randomly() {
     m_paths.clear();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> path_length_dist(MIN_PATH_LENGTH, MAX_PATH_LENGTH);
     std::uniform_int_distribution<int> path_count_dist(MIN_PATHS, MAX_PATHS);
@@ -125,10 +130,25 @@ void RuleWhisper::init_randomly() {
             continue; // skip paths that are too short
         m_paths.push_back(path);
     }
+
+    m_lookup.build(board_->size(), m_paths);
 }
 
 // private member functions
 
+bool RuleWhisper::valid_path(const Region<CellIdx> &path) {
+    const auto &items = path.items();
+    for (size_t i = 0; i < path.size() - 1; i++) {
+        Cell &cell1 = board_->get_cell(items[i]);
+        Cell &cell2 = board_->get_cell(items[i + 1]);
+
+        if (!valid_pair(cell1, cell2))
+            return false;
+    }
+
+    return true;
+}
+
 bool RuleWhisper::apply_number_contraint(Cell &cell1, Cell &cell2) {
     if (!cell1.is_solved() || cell2.is_solved())
         return false;
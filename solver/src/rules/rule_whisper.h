@@ -13,6 +13,10 @@ public:
     bool number_changed(CellIdx pos) override;
     bool candidates_changed() override;
     bool valid() override;
+    bool valid_changed(const std::vector<CellIdx> &cells) override;
+    Region<CellIdx> watched_cells() const override;
+    Region<CellIdx> subscribed_cells() const override;
+    std::vector<Region<CellIdx>> constraint_groups() const override;
     void update_impact(ImpactMap &map) override;
 
     void from_json(JSON &json) override;
@@ -20,6 +24,8 @@ public:
 
     void init_randomly() override;
 
+    std::shared_ptr<RuleHandler> clone(Board *board) const override { return clone_to(*this, board); }
+
 private:
     // hyperparameters
     const int MIN_PATH_LENGTH = 2;
@@ -29,11 +35,13 @@ private:
 
     // standard parameters
     std::vector<Region<CellIdx>> m_paths;
+    CellLookup m_lookup; ///< Paths touching each cell
 
     // private member functions
     bool apply_number_contraint(Cell &cell1, Cell &cell2);
     bool apply_candidate_contraint(Cell &cell1, Cell &cell2);
     bool valid_pair(Cell &cell1, Cell &cell2);
+    bool valid_path(const Region<CellIdx> &path);
 };
 
 } // namespace sudoku
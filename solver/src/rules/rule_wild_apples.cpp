@@ -55,6 +55,10 @@ bool RuleWildApples::valid() {
     return true;
 }
 
+Region<CellIdx> RuleWildApples::watched_cells() const {
+    return m_apple_edges.attached_cells(board_->size());
+}
+
 void RuleWildApples::update_impact(ImpactMap &map) {
     for (const auto &edge: m_apple_edges.items()) {
         map.increment({edge.r1, edge.c1});
@@ -109,8 +113,7 @@ JSON RuleWildApples::to_json() const {
 }
 
 void RuleWildApples::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
     std::uniform_int_distribution<int> dist(MIN_WILD_APPLES, MAX_WILD_APPLES);
     const int num_apples = dist(gen);
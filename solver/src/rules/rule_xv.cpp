@@ -58,6 +58,19 @@ bool RuleXV::valid() {
     return true;
 }
 
+Region<CellIdx> RuleXV::watched_cells() const {
+    const int board_size = board_->size();
+    Region<CellIdx> cells = m_x_edges.attached_cells(board_size) | m_v_edges.attached_cells(board_size);
+    if (m_all_dots_given)
+        cells = cells | m_missing_edges.attached_cells(board_size);
+    return cells;
+}
+
+Region<CellIdx> RuleXV::subscribed_cells() const {
+    // number_changed() does nothing
+    return {};
+}
+
 void RuleXV::update_impact(ImpactMap &map) {
     for (const auto &edge: m_x_edges.items()) {
         map.increment({edge.r1, edge.c1});
@@ -134,10 +147,9 @@ JSON RuleXV::to_json() const {
 }
 
 void RuleXV::init_randomly() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    Rng &gen = board_->rng();
 
-    m_all_dots_given = rand() % 2 == 0;
+    m_all_dots_given = std::bernoulli_distribution(0.5)(gen);
 
     std::uniform_int_distribution<int> x_dist(MIN_X_EDGES, MAX_X_EDGES);
     const int num_x = x_dist(gen);
@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 
+#include "alloc_counter.h"
+
 
 /**
  * @struct SolverStats
@@ -24,7 +27,10 @@ struct SolverStats {
     int solutions_found = 0; ///< Number of valid solutions found.
     int nodes_explored = 0; ///< Number of nodes (decisions) explored.
     int guesses_made = 0; ///< Total guesses made during solving.
+    int restarts = 0; ///< Number of times the search was restarted from the root.
+    int handler_calls = 0; ///< Number of rule handler invocations during solving.
     float time_taken_ms = 0.0f; ///< Elapsed time in milliseconds.
+    uint64_t allocations = 0; ///< Heap allocations during solving (only counted with SUDOKU_COUNT_ALLOCATIONS).
 
     bool interrupted_by_node_limit = false; ///< Whether solving was interrupted due to a node limit.
     bool interrupted_by_solution_limit = false; ///< Whether solving was interrupted due to a solution limit.
@@ -56,11 +62,22 @@ inline std::ostream &operator<<(std::ostream &os, const SolverStats &stats) {
     os << "| " << std::setw(26) << std::left << "Guesses Made:";
     os << std::setw(12) << std::right << stats.guesses_made << " |\n";
 
+    os << "| " << std::setw(26) << std::left << "Restarts:";
+    os << std::setw(12) << std::right << stats.restarts << " |\n";
+
+    os << "| " << std::setw(26) << std::left << "Handler Calls:";
+    os << std::setw(12) << std::right << stats.handler_calls << " |\n";
+
     os << "| " << std::setw(26) << std::left << "Time (ms):";
     std::stringstream time_ss;
     time_ss << std::fixed << std::setprecision(3) << stats.time_taken_ms;
     os << std::setw(12) << std::right << time_ss.str() << " |\n";
 
+    if (sudoku::alloc_counter::enabled) {
+        os << "| " << std::setw(26) << std::left << "Allocations:";
+        os << std::setw(12) << std::right << stats.allocations << " |\n";
+    }
+
     os << "| " << std::setw(26) << std::left << "Node Limit Reached:";
     std::string node_limit_str = stats.interrupted_by_node_limit ? "Yes" : "No";
     os << std::setw(12) << std::right << node_limit_str << " |\n";